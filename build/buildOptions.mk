@@ -72,6 +72,12 @@ BLASLIB?=blas
 CXXFLAGS= $(CXXSTD) $(OPT) $(OMP) $(WARN) -I$(SD)
 LIBS=-lgsl -lgslcblas -llapack -l$(BLASLIB)
 
+# LinAlg calls BLAS/LAPACK directly (so uses BLASLIB for matrix products).
+# Set LinAlgBackend=gsl to use the GSL routines (and GSL's CBLAS) instead
+ifeq ($(LinAlgBackend),gsl)
+  CXXFLAGS+=-DLINALG_GSL_BACKEND
+endif
+
 # GSL location (if different from assumed default)
 ifneq ($(PathForGSL),)
   CXXFLAGS+=-I$(PathForGSL)/include/
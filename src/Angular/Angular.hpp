@@ -1,5 +1,6 @@
 #pragma once
 #include "Angular/CkTable.hpp"
+#include "Angular/RecouplingTable.hpp"
 #include "Angular/SixJTable.hpp"
 #include "Angular/Wigner369j.hpp"
 
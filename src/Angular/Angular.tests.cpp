@@ -1,4 +1,5 @@
 #include "Angular/CkTable.hpp"
+#include "Angular/RecouplingTable.hpp"
 #include "Angular/SixJTable.hpp"
 #include "IO/ChronoTimer.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
@@ -6,6 +7,7 @@
 #include "qip/Maths.hpp"
 #include "qip/Vector.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <gsl/gsl_version.h>
 #include <string>
@@ -26,8 +28,9 @@ namespace UnitTest {
 // j), and calculates {C^k, 3j} symbol multiple ways (using lookup table, +
 // direct calculation from basic formulas etc.). Checks all these against each
 // other, and returns the eps of the worst comparison. Ck must be pre-filled,
-// ck_m may be empty initially (_mutable versions are called)
-double ck_compare_direct(const Angular::CkTable &Ck, Angular::CkTable &Ck_m);
+// ck_m may be empty initially (is extended as required)
+double ck_compare_direct(const Angular::CkTable &Ck,
+                         const Angular::CkTable &Ck_m);
 
 // Loops through all possible 6j tables (including non-physical) and compares to
 // direct calculation. Returns maximum difference (absolute value)
@@ -236,9 +239,8 @@ TEST_CASE("Angular: Ck tables", "[Angular][unit]") {
 
   // Maximum value of 2*j (for initial run)
   const int max2j_1 = 5;
-  // Form C^k lookup tables. One used statically, one dynamically re-sized
-  // ("dynamic" one uses the _mutable lookup functions, that calclate the
-  // angular factor if it doesn't exist already)
+  // Form C^k lookup tables. One filled in advance, one dynamically re-sized
+  // (calculates the angular factor if it doesn't exist already)
   Angular::CkTable Ck(max2j_1);
   Angular::CkTable Ck_dynamic(0);
   REQUIRE(Ck.max_tj() >= max2j_1);
@@ -269,6 +271,36 @@ TEST_CASE("Angular: Ck tables", "[Angular][unit]") {
     const auto max_eps3 = UnitTest::ck_compare_direct(Ck, Ck_dynamic);
     REQUIRE(max_eps3 < 1.0e-13);
   }
+
+  // Empty table, shared between threads: grows lazily (and safely)
+  {
+    const Angular::CkTable Ck_shared(0);
+    double max_eps = 0.0;
+#pragma omp parallel for collapse(2) reduction(max : max_eps)
+    for (int kia = 40; kia >= 0; --kia) {
+      for (int kib = 0; kib <= 40; ++kib) {
+        const auto ka = Angular::kappaFromIndex(kia);
+        const auto kb = Angular::kappaFromIndex(kib);
+        for (int k = 0; k <= 24; ++k) {
+          const auto c1 = Ck_shared.get_Ckab(k, ka, kb);
+          const auto c2 = Angular::Ck_kk(k, ka, kb);
+          const auto t1 = Ck_shared.get_3jkab(k, ka, kb);
+          const auto t2 = Angular::special_threej_2(
+              Angular::twoj_k(ka), Angular::twoj_k(kb), 2 * k);
+          max_eps = qip::max_abs(max_eps, c1 - c2, t1 - t2);
+        }
+      }
+    }
+    REQUIRE(max_eps < 1.0e-13);
+    REQUIRE(Ck_shared.max_tj() == Angular::twojFromIndex(40));
+    // beyond stored range: still correct (calculated directly)
+    REQUIRE(Ck_shared.get_Ckab(3, -70, 69) ==
+            Approx(Angular::Ck_kk(3, -70, 69)));
+    // copies are independent
+    const auto Ck_copy = Ck_shared;
+    REQUIRE(Ck_copy.max_tj() == Ck_shared.max_tj());
+    REQUIRE(Ck_copy.get_Ckab(2, -3, 2) == Ck_shared.get_Ckab(2, -3, 2));
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -301,6 +333,76 @@ TEST_CASE("Angular: 6j tables", "[Angular][unit]") {
   }
 }
 
+//------------------------------------------------------------------------------
+TEST_CASE("Angular: 9j and recoupling tables", "[Angular][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "Angular: 9j and recoupling tables\n";
+
+  // All 9j symbols {ja jb J \ jc jd J' \ k1 k2 K}, for j<=5/2, k<=2
+  // Filled from many threads at once; each pass after the first is lookups
+  Angular::NineJTable nj;
+  const int max_tj = 5, max_k = 4;
+  double max_del = 0.0;
+  for (int pass = 0; pass < 2; ++pass) {
+#pragma omp parallel for collapse(2) reduction(max : max_del)
+    for (int a = 1; a <= max_tj; a += 2) {
+      for (int b = 1; b <= max_tj; b += 2) {
+        for (int c = 1; c <= max_tj; c += 2) {
+          for (int d = 1; d <= max_tj; d += 2) {
+            for (int J = 0; J <= 2 * max_tj; J += 2) {
+              for (int Jp = 0; Jp <= 2 * max_tj; Jp += 2) {
+                for (int k1 = 0; k1 <= max_k; k1 += 2) {
+                  for (int k2 = 0; k2 <= max_k; k2 += 2) {
+                    for (int K = 0; K <= 2 * max_k; K += 2) {
+                      const auto nj1 = nj.get_2(a, b, J, c, d, Jp, k1, k2, K);
+                      const auto nj2 =
+                          gsl_sf_coupling_9j(a, b, J, c, d, Jp, k1, k2, K);
+                      max_del = std::max(max_del, std::abs(nj1 - nj2));
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  REQUIRE(max_del < 1.0e-14);
+  REQUIRE(nj.size() > 0);
+  const auto size = nj.size();
+  // 'magic' interface, and transpose symmetry
+  const auto Fa = DiracSpinor(0, -2, nullptr); // j=3/2
+  REQUIRE(nj.get(Fa, Fa, 1, Fa, Fa, 1, 1, 1, 2) ==
+          Approx(gsl_sf_coupling_9j(3, 3, 2, 3, 3, 2, 2, 2, 4)));
+  REQUIRE(nj.get_2(3, 1, 2, 5, 3, 2, 4, 2, 4) ==
+          nj.get_2(3, 5, 4, 1, 3, 2, 2, 2, 4));
+  REQUIRE(nj.size() >= size);
+
+  // General recoupling coefficient: product of 6j and 3j symbols
+  const auto f = [](const std::array<int, 4> &t) {
+    const auto [ja, jb, k, J] = t;
+    return Angular::sixj_2(ja, jb, J, jb, ja, k) *
+           Angular::threej_2(ja, ja, k, -1, 1, 0);
+  };
+  Angular::RecouplingTable<4> rt(f);
+  for (int tja = 1; tja <= 9; tja += 2) {
+    for (int tjb = 1; tjb <= 9; tjb += 2) {
+      for (int k = 0; k <= 8; k += 2) {
+        for (int J = 0; J <= 10; J += 2) {
+          REQUIRE(rt.get_2(tja, tjb, k, J) == f({tja, tjb, k, J}));
+        }
+      }
+    }
+  }
+  REQUIRE(rt.size() == 5 * 5 * 5 * 6);
+  // outside packed range: calculated directly, not stored
+  REQUIRE(rt.get_2(201, 1, 200, 2) == f({201, 1, 200, 2}));
+  REQUIRE(rt.size() == 5 * 5 * 5 * 6);
+  rt.clear();
+  REQUIRE(rt.size() == 0);
+}
+
 //------------------------------------------------------------------------------
 TEST_CASE("Angular: 6j tables - performance",
           "[Angular][!mayfail][performance]") {
@@ -320,7 +422,7 @@ TEST_CASE("Angular: 6j tables - performance",
 //==============================================================================
 //==============================================================================
 double UnitTest::ck_compare_direct(const Angular::CkTable &Ck,
-                                   Angular::CkTable &Ck_m) {
+                                   const Angular::CkTable &Ck_m) {
   const auto max2j = Ck.max_tj();
   double max = 0.0;
 
@@ -339,7 +441,7 @@ double UnitTest::ck_compare_direct(const Angular::CkTable &Ck,
       for (int k = 0; k <= max2j; ++k) {
 
         const auto c1 = Ck.get_Ckab(k, ka, kb);
-        const auto c1_m = Ck_m.get_Ckab_mutable(k, ka, kb);
+        const auto c1_m = Ck_m.get_Ckab(k, ka, kb);
         const auto c2 = Angular::Ck_kk(k, ka, kb);
         const auto sign = ((tja + 1) / 2) % 2 == 0 ? 1 : -1;
         const auto c3 = Angular::parity(Angular::l_k(ka), Angular::l_k(kb), k) *
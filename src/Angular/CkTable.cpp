@@ -1,119 +1,106 @@
 #include "Angular/CkTable.hpp"
 #include "Angular/Wigner369j.hpp"
 #include <cassert>
+#include <cmath>
 
 #pragma GCC diagnostic ignored "-Wsign-conversion"
 
 namespace Angular {
 //==============================================================================
-void CkTable::fill(const int in_max_twoj) {
-
-  // re-factor. No longer allow 2j and k to diverge
-  const int in_max_K = in_max_twoj;
+CkTable::CkTable(const CkTable &other) { *this = other; }
+
+CkTable &CkTable::operator=(const CkTable &other) {
+  if (this == &other)
+    return *this;
+  std::scoped_lock lock(m_mutex, other.m_mutex);
+  const auto max_jindex = other.m_max_jindex.load();
+  for (int jia = 0; jia <= m_max_jindex_cap; ++jia) {
+    if (jia > max_jindex) {
+      m_block[jia].reset();
+      continue;
+    }
+    const auto size = 2 * block_size(jia);
+    m_block[jia] = std::make_unique<double[]>(size);
+    std::copy(other.m_block[jia].get(), other.m_block[jia].get() + size,
+              m_block[jia].get());
+  }
+  m_max_jindex.store(max_jindex);
+  return *this;
+}
 
-  // auto max_jindex = (in_max_twoj - 1) / 2;
-  auto max_jindex = Angular::jindex(in_max_twoj);
-  if (max_jindex <= m_max_jindex_sofar)
+//==============================================================================
+void CkTable::fill(const int in_max_twoj) const {
+  const auto max_jindex = std::min(Angular::jindex(in_max_twoj),
+                                   m_max_jindex_cap);
+  if (max_jindex <= m_max_jindex.load(std::memory_order_acquire))
     return;
+  std::lock_guard lock(m_mutex);
+  extend(max_jindex);
+}
 
-  if (max_jindex < m_max_jindex_sofar)
-    max_jindex = m_max_jindex_sofar;
-  auto max_k = in_max_K > m_max_k_sofar ? in_max_K : m_max_k_sofar;
-
-  m_Rjab_a_b.resize(max_jindex + 1);
-  for (int jia = m_max_jindex_sofar + 1; jia <= max_jindex; jia++) {
-    m_Rjab_a_b[jia].reserve(jia + 1);
-    for (int jib = 0; jib <= jia; jib++) {
-      auto tjpqtjpq = static_cast<double>((2 * jia + 2) * (2 * jib + 2));
-      m_Rjab_a_b[jia].push_back(std::sqrt(tjpqtjpq));
+//------------------------------------------------------------------------------
+void CkTable::extend(int max_jindex) const {
+  // nb: another thread may have extended the table while we waited for lock
+  const auto max_jindex_sofar = m_max_jindex.load(std::memory_order_relaxed);
+  for (int jia = max_jindex_sofar + 1; jia <= max_jindex; ++jia) {
+    const auto size = block_size(jia);
+    auto block = std::make_unique<double[]>(2 * size);
+    const auto tja = twoj(jia);
+    for (int jib = 0; jib <= jia; ++jib) {
+      const auto tjb = twoj(jib);
+      const auto Rjab = std::sqrt(double((tja + 1) * (tjb + 1)));
+      for (int k = jia - jib; k <= jia + jib + 1; ++k) {
+        const auto tjs = Angular::special_threej_2(tja, tjb, 2 * k);
+        block[index(k, jia, jib)] = tjs;
+        block[size + index(k, jia, jib)] = tjs * Rjab;
+      }
     }
+    m_block[jia] = std::move(block);
   }
+  // 'release': new blocks are visible to any thread that sees new max
+  if (max_jindex > max_jindex_sofar)
+    m_max_jindex.store(max_jindex, std::memory_order_release);
+}
 
-  m_3j_k_a_b.resize(max_k + 1);
-  for (int k = 0; k <= max_k; k++) {
-    m_3j_k_a_b[k].resize(max_jindex + 1);
-    auto beg_jia = (k <= m_max_k_sofar) ? m_max_jindex_sofar + 1 : 0;
-    for (int jia = beg_jia; jia <= max_jindex; jia++) {
-      m_3j_k_a_b[k][jia].reserve(jia + 1);
-      for (int jib = 0; jib <= jia; jib++) {
-        auto tja = 2 * jia + 1;
-        auto tjb = 2 * jib + 1;
-        m_3j_k_a_b[k][jia].push_back(
-            Angular::special_threej_2(tja, tjb, 2 * k));
-      }
+//------------------------------------------------------------------------------
+std::pair<double, double> CkTable::lookup(int k, int jia, int jib) const {
+  if (jia < jib)
+    std::swap(jia, jib);
+  // triangle rule
+  if (k < jia - jib || k > jia + jib + 1)
+    return {0.0, 0.0};
+
+  if (jia > m_max_jindex.load(std::memory_order_acquire)) {
+    if (jia > m_max_jindex_cap) {
+      const auto tjs = Angular::special_threej_2(twoj(jia), twoj(jib), 2 * k);
+      return {tjs, tjs * std::sqrt(double((twoj(jia) + 1) * (twoj(jib) + 1)))};
     }
+    std::lock_guard lock(m_mutex);
+    extend(jia);
   }
-
-  m_max_jindex_sofar = max_jindex;
-  m_max_k_sofar = in_max_K;
+  const auto *block = m_block[jia].get();
+  const auto i = index(k, jia, jib);
+  return {block[i], block[block_size(jia) + i]};
 }
 
 //==============================================================================
-double CkTable::get_tildeCkab_mutable(int k, int ka, int kb) {
-  auto jia = jindex_kappa(ka);
-  auto jib = jindex_kappa(kb);
-  // parity:
-  auto pi_ok = Angular::evenQ(Angular::l_k(ka) + Angular::l_k(kb) + k);
-  if (!pi_ok)
-    return 0;
-
-  auto maxji = std::max(jia, jib);
-  if (maxji > m_max_jindex_sofar || k > m_max_k_sofar)
-    fill(std::max(k, twoj(maxji)) + 1); // XXX Hack? Why need +1 ??
-  return (jia > jib) ? m_3j_k_a_b[k][jia][jib] * m_Rjab_a_b[jia][jib] :
-                       m_3j_k_a_b[k][jib][jia] * m_Rjab_a_b[jib][jia];
-}
-
 double CkTable::get_tildeCkab(int k, int ka, int kb) const {
-  auto jia = jindex_kappa(ka);
-  auto jib = jindex_kappa(kb);
   // parity:
-  auto pi_ok = Angular::evenQ(Angular::l_k(ka) + Angular::l_k(kb) + k);
+  const auto pi_ok = Angular::evenQ(Angular::l_k(ka) + Angular::l_k(kb) + k);
   if (!pi_ok)
     return 0.0;
-
-  if (Angular::triangle(twoj_k(ka), twoj_k(kb), 2 * k) == 0)
-    return 0.0;
-  // if (std::max(jia, jib) > m_max_jindex_sofar) {
-  //   std::cout << k << " " << ka << " " << kb << "\n";
-  //   std::cout << "m_max_jindex_sofar " << m_max_jindex_sofar << " - "
-  //             << twoj(m_max_jindex_sofar) << "\n";
-  //   std::cout << "jia " << jia << " - " << twoj(jia) << "\n";
-  //   std::cout << "jib " << jib << " - " << twoj(jib) << "\n";
-  // }
-  assert(std::max(jia, jib) <= m_max_jindex_sofar);
-  assert(k <= m_max_k_sofar);
-  return (jia > jib) ? m_3j_k_a_b[k][jia][jib] * m_Rjab_a_b[jia][jib] :
-                       m_3j_k_a_b[k][jib][jia] * m_Rjab_a_b[jib][jia];
+  return lookup(k, jindex_kappa(ka), jindex_kappa(kb)).second;
 }
 
 //==============================================================================
-double CkTable::get_Ckab_mutable(int k, int ka, int kb) {
-  auto s = Angular::evenQ_2(Angular::twoj_k(ka) + 1) ? 1.0 : -1.0;
-  return s * get_tildeCkab_mutable(k, ka, kb);
-}
-
 double CkTable::get_Ckab(int k, int ka, int kb) const {
   auto s = Angular::evenQ_2(Angular::twoj_k(ka) + 1) ? 1.0 : -1.0;
   return s * get_tildeCkab(k, ka, kb);
 }
 
 //==============================================================================
-double CkTable::get_3jkab_mutable(int k, int ka, int kb) {
-  auto jia = jindex_kappa(ka);
-  auto jib = jindex_kappa(kb);
-  auto maxji = std::max(jia, jib);
-  if (maxji > m_max_jindex_sofar || k > m_max_k_sofar)
-    fill(std::max(k, twoj(maxji)));
-  return (jia > jib) ? m_3j_k_a_b[k][jia][jib] : m_3j_k_a_b[k][jib][jia];
-}
-
 double CkTable::get_3jkab(int k, int ka, int kb) const {
-  auto jia = jindex_kappa(ka);
-  auto jib = jindex_kappa(kb);
-  assert(std::max(jia, jib) <= m_max_jindex_sofar);
-  assert(k <= m_max_k_sofar);
-  return (jia > jib) ? m_3j_k_a_b[k][jia][jib] : m_3j_k_a_b[k][jib][jia];
+  return lookup(k, jindex_kappa(ka), jindex_kappa(kb)).first;
 }
 
 double CkTable::get_Lambdakab(int k, int ka, int kb) const {
@@ -1,89 +1,107 @@
-#pragma once
-#include "Angular/Wigner369j.hpp"
-#include <algorithm>
-#include <iostream>
-#include <vector>
-
-namespace Angular {
-
-//==============================================================================
-// "Helper" functions
-//! Converts jindex to 2*j [helper function]
-constexpr int twoj(int jindex) { return 2 * jindex + 1; }
-//! Converts 2*j to jindex {1/2, 3/2, 5/2} -> {0, 1, 2} [helper function]
-constexpr int jindex(int twoj) { return (twoj - 1) / 2; }
-//! Converts kappa to jindex {-1, 1, -2} -> {0, 0, 1} [helper function]
-constexpr int jindex_kappa(int ka) { return (ka > 0) ? ka - 1 : -ka - 1; }
-
-//==============================================================================
-/*!
-@brief Lookup table for C^k and 3j symbols (special m=1/2, q=0 case)
-@details
-  - Builds 3j symbol lookup table for given maximum k and maximum j (2j)
-  - 3j symbols, special case: (ja jb k \\ -1/2, 1/2, 0)
-  - Ckab : \f$C^k_{ab} = \langle k_a||C^k||k_b \rangle\f$ 
-    [symmetric up to +/- sign]
-  - TildeCkab : \f$\widetilde C^k_{ab} = (-1)^{ja+1/2} C^k_{ab}\f$ [symmetric]
-  - Slightly faster than calculating on-the-fly, but adds some overhead
-\par Construction
-  - Needs maximum two*j values. Will build look-up tables for all possible
-symbols.
-\par Mutable versions
-  - Some functions come with '_mutable' versions
-  - These will calculate (+ store) values if they don't exist yet
-  - '_mutable' versions are NOT thread safe (non-mutable are)
-  - The non-mutable versions: must not be called if symbol hasn't been 
-    calculated. This is undefined behaviour
-  - You can check which symbols exist by calling max_tj() and max_k()
-  - All "lower" symbols are calculated [max_tj, max_k defined all]
-\par Usage
-  - Note: Functions take k and kappa_a, kappa_b as input!
-*/
-class CkTable {
-
-public:
-  //! Calculates and stored all Ck/3j symbols up to given maximum 2j
-  CkTable(const int in_max_twoj = 0) { fill(in_max_twoj); }
-
-public:
-  //! Extends existing look-up table to new twoj.
-  /*! 
-  @details 
-  nb: called on construction automatically, you only need to call this if you 
-  need to extend the table after original construction (rare)
-  */
-  void fill(const int in_max_twoj);
-
-  //! Ckab. mutable: will calculate if needed. Not thread safe
-  double get_Ckab_mutable(int k, int ka, int kb);
-  //! tildeCkab. mutable: will calculate if needed. Not thread safe
-  double get_tildeCkab_mutable(int k, int ka, int kb);
-  //! special 3j(k, ka, kb). mutable: will calculate if needed. Not thread safe
-  double get_3jkab_mutable(int k, int ka, int kb);
-
-  //! Ckab. Undefined if k, ka, or kb are out-of-bounds [check with max_tj()].
-  double get_Ckab(int k, int ka, int kb) const;
-  //! tildeCkab. Undefined if k, ka, or kb are out-of-bounds
-  double get_tildeCkab(int k, int ka, int kb) const;
-  //! special 3j(k, ka, kb). Undefined if k, ka, or kb are out-of-bounds
-  double get_3jkab(int k, int ka, int kb) const;
-
-  //! Operator overload: returns Ckab
-  double operator()(int k, int ka, int kb) const { return get_Ckab(k, ka, kb); }
-
-  //! Lambda^k_ij := 3js((ji,jj,k),(-1/2,1/2,0))^2 * parity(li+lj+k)
-  double get_Lambdakab(int k, int ka, int kb) const;
-
-  //! Maximum value for 2j currently stored in tables
-  int max_tj() const { return twoj(m_max_jindex_sofar); }
-  //! Maximum value for k currently stored in tables
-  int max_k() const { return m_max_k_sofar; }
-
-private:
-  std::vector<std::vector<std::vector<double>>> m_3j_k_a_b = {};
-  std::vector<std::vector<double>> m_Rjab_a_b = {}; // Sqrt([ja][jb])
-  int m_max_jindex_sofar = -1;
-  int m_max_k_sofar = -1;
-};
-
-} // namespace Angular
+#pragma once
+#include "Angular/Wigner369j.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Angular {
+
+//==============================================================================
+// "Helper" functions
+//! Converts jindex to 2*j [helper function]
+constexpr int twoj(int jindex) { return 2 * jindex + 1; }
+//! Converts 2*j to jindex {1/2, 3/2, 5/2} -> {0, 1, 2} [helper function]
+constexpr int jindex(int twoj) { return (twoj - 1) / 2; }
+//! Converts kappa to jindex {-1, 1, -2} -> {0, 0, 1} [helper function]
+constexpr int jindex_kappa(int ka) { return (ka > 0) ? ka - 1 : -ka - 1; }
+
+//==============================================================================
+/*!
+@brief Lookup table for C^k and 3j symbols (special m=1/2, q=0 case)
+@details
+  - Builds 3j symbol lookup table for given maximum k and maximum j (2j)
+  - 3j symbols, special case: (ja jb k \\ -1/2, 1/2, 0)
+  - Ckab : \f$C^k_{ab} = \langle k_a||C^k||k_b \rangle\f$ 
+    [symmetric up to +/- sign]
+  - TildeCkab : \f$\widetilde C^k_{ab} = (-1)^{ja+1/2} C^k_{ab}\f$ [symmetric]
+  - Slightly faster than calculating on-the-fly, but adds some overhead
+\par Construction
+  - Takes maximum two*j value; builds look-up tables for all possible
+symbols up to this (all k allowed by triangle rule). This is optional.
+\par Thread safety
+  - The table grows lazily: requesting a symbol with larger j than is stored
+    calculates (and stores) the new symbols. This is thread safe: the table
+    may be shared between many (OpenMP) threads, without being pre-sized.
+  - Storage is flat: one contiguous block per j_a (with j_b <= j_a, and
+    |ja-jb| <= k <= ja+jb), which are never moved once created. Lookups of
+    existing symbols do not lock.
+  - Symbols with 2j > 127 are not stored (calculated each time)
+  - You can check which symbols exist by calling max_tj()
+\par Usage
+  - Note: Functions take k and kappa_a, kappa_b as input!
+*/
+class CkTable {
+
+public:
+  //! Calculates and stored all Ck/3j symbols up to given maximum 2j
+  CkTable(const int in_max_twoj = 0) { fill(in_max_twoj); }
+
+  CkTable(const CkTable &other);
+  CkTable &operator=(const CkTable &other);
+  ~CkTable() = default;
+
+public:
+  //! Extends existing look-up table to new twoj.
+  /*! 
+  @details 
+  nb: called on construction automatically. Calling this is never required
+  (table is extended as required), but may be used to pre-fill the table
+  */
+  void fill(const int in_max_twoj) const;
+
+  //! Ckab. Will calculate (and store) if required; thread safe
+  double get_Ckab(int k, int ka, int kb) const;
+  //! tildeCkab. Will calculate (and store) if required; thread safe
+  double get_tildeCkab(int k, int ka, int kb) const;
+  //! special 3j(k, ka, kb). Will calculate (and store) if required
+  double get_3jkab(int k, int ka, int kb) const;
+
+  //! Operator overload: returns Ckab
+  double operator()(int k, int ka, int kb) const { return get_Ckab(k, ka, kb); }
+
+  //! Lambda^k_ij := 3js((ji,jj,k),(-1/2,1/2,0))^2 * parity(li+lj+k)
+  double get_Lambdakab(int k, int ka, int kb) const;
+
+  //! Maximum value for 2j currently stored in tables
+  int max_tj() const { return twoj(m_max_jindex.load()); }
+  //! Maximum value for k currently stored in tables (=max_tj)
+  int max_k() const { return max_tj(); }
+
+private:
+  static constexpr int m_max_jindex_cap = 63; // 2j = 127
+  // m_block[jia]: 3j symbols for all jib<=jia (and k), followed by the same
+  // number of tildeCk's (without parity). See index()
+  mutable std::array<std::unique_ptr<double[]>, m_max_jindex_cap + 1>
+      m_block{};
+  mutable std::atomic<int> m_max_jindex{-1};
+  mutable std::mutex m_mutex{};
+
+  // Number of symbols in block for jia
+  static constexpr std::size_t block_size(int jia) {
+    return std::size_t((jia + 1) * (jia + 2));
+  }
+  // Position of {k, jia, jib} in block jia; requires jib<=jia, k allowed
+  static constexpr std::size_t index(int k, int jia, int jib) {
+    return std::size_t(jib * (jib + 1) + k - (jia - jib));
+  }
+  // Returns {3j, tildeCk (no parity)}; calculates if not stored
+  std::pair<double, double> lookup(int k, int jia, int jib) const;
+  void extend(int max_jindex) const; // nb: m_mutex must be held
+};
+
+} // namespace Angular
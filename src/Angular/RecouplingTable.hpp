@@ -0,0 +1,165 @@
+#pragma once
+#include "Angular/Wigner369j.hpp"
+#include "Wavefunction/DiracSpinor.hpp" // for 'magic' 9J symbols
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace Angular {
+
+//==============================================================================
+//! Thread-safe, lazily-filled lookup table for any angular (recoupling)
+//! coefficient of N angular momenta (e.g., products of 3j/6j/9j symbols).
+/*! @details
+Note: called with 2*j and 2*k (as int), same as SixJTable.
+
+The coefficient is calculated (by the function given on construction) the first
+time it is requested, and stored; subsequent requests are a hash-table lookup.
+May be called concurrently from many (OpenMP) threads: lookups take a shared
+lock, and only the (rare) insertions take an exclusive lock.
+
+Arguments are packed 7 bits each into a 64-bit key, so N<=9 and each 2j<=127.
+Requests outside this range are calculated directly (not stored).
+
+e.g., a coefficient that appears in a two-particle reduced matrix element:
+@code{.cpp}
+  Angular::RecouplingTable<6> ab([](const std::array<int, 6> &t) {
+    const auto [ja, jb, k, jc, jd, J] = t;
+    return Angular::sixj_2(ja, jb, J, jd, jc, k) *
+           Angular::threej_2(ja, jc, k, -1, 1, 0);
+  });
+  const auto x = ab.get_2(tja, tjb, 2 * k, tjc, tjd, twoJ);
+@endcode
+*/
+template <std::size_t N>
+class RecouplingTable {
+  static_assert(N >= 1 && N <= 9, "RecouplingTable: require 1 <= N <= 9");
+
+public:
+  using Function = std::function<double(const std::array<int, N> &)>;
+
+private:
+  Function m_f;
+  mutable std::unordered_map<uint64_t, double> m_data{};
+  mutable std::shared_mutex m_mutex{};
+  static constexpr int max_2j = 127;
+
+public:
+  //! f is the coefficient (of 2*j's) to be tabulated
+  explicit RecouplingTable(Function f) : m_f(std::move(f)) {}
+
+  //! Returns f({tj...}): calculated on first call, looked up thereafter
+  double get_2(const std::array<int, N> &tj) const {
+    uint64_t key = 0;
+    for (const auto x : tj) {
+      if (x < 0 || x > max_2j)
+        return m_f(tj);
+      key = (key << 7) | uint64_t(x);
+    }
+    {
+      std::shared_lock lock(m_mutex);
+      const auto it = m_data.find(key);
+      if (it != m_data.cend())
+        return it->second;
+    }
+    const auto value = m_f(tj);
+    std::unique_lock lock(m_mutex);
+    m_data.emplace(key, value);
+    return value;
+  }
+
+  //! Returns f({tj...}): calculated on first call, looked up thereafter
+  template <class... Ints>
+  double get_2(int tj0, Ints... tjs) const {
+    static_assert(sizeof...(Ints) + 1 == N);
+    return get_2(std::array<int, N>{tj0, tjs...});
+  }
+
+  //! Number of coefficients stored
+  std::size_t size() const {
+    std::shared_lock lock(m_mutex);
+    return m_data.size();
+  }
+
+  //! Clears the stored coefficients
+  void clear() {
+    std::unique_lock lock(m_mutex);
+    m_data.clear();
+  }
+};
+
+//==============================================================================
+//! Thread-safe, lazily-filled lookup table for Wigner 9J symbols.
+/*! @details
+Note: functions all called with 2*j and 2*k (ensure j integer), as for
+SixJTable. Unlike SixJTable, need not (cannot) be filled in advance: each symbol
+is calculated the first time it is requested. Symbols that are zero by triangle
+(or integer-sum) rules return zero without a lookup. Makes use of the transpose
+symmetry (row/column permutations, which carry a phase, are not used).
+*/
+class NineJTable {
+private:
+  RecouplingTable<9> m_table{[](const std::array<int, 9> &t) {
+    return Angular::ninej_2(t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7],
+                            t[8]);
+  }};
+
+public:
+  NineJTable() = default;
+
+  //! Returns number of symbols stored
+  std::size_t size() const { return m_table.size(); }
+
+  //----------------------------------------------------------------------------
+  //! Return 9j symbol {a b c \ d e f \ g h i} (each /2). Note: takes in
+  //! 2*j/2*k as int
+  double get_2(int a, int b, int c, int d, int e, int f, int g, int h,
+               int i) const {
+    if (zeroQ(a, b, c, d, e, f, g, h, i))
+      return 0.0;
+    // {a b c \ d e f \ g h i} = {a d g \ b e h \ c f i}: store lower of two
+    if (std::array{b, c, f} > std::array{d, g, h})
+      return m_table.get_2(a, d, g, b, e, h, c, f, i);
+    return m_table.get_2(a, b, c, d, e, f, g, h, i);
+  }
+
+  //! Return "magic" 9j. Pass in either integer (for k), or DiracSpinor, F.
+  //! e.g.: (F,F,k,...) -> {j,j,k,...}. Do NOT *2!
+  template <class A, class B, class C, class D, class E, class F, class G,
+            class H, class I>
+  double get(const A &a, const B &b, const C &c, const D &d, const E &e,
+             const F &f, const G &g, const H &h, const I &i) const {
+    return get_2(twojk(a), twojk(b), twojk(c), twojk(d), twojk(e), twojk(f),
+                 twojk(g), twojk(h), twojk(i));
+  }
+
+  //! Checks triangle (and integer-sum) conditions for each row and column
+  static bool zeroQ(int a, int b, int c, int d, int e, int f, int g, int h,
+                    int i) {
+    const auto tri = [](int x, int y, int z) {
+      return triangle(x, y, z) != 0 && evenQ(x + y + z);
+    };
+    return !(tri(a, b, c) && tri(d, e, f) && tri(g, h, i) && tri(a, d, g) &&
+             tri(b, e, h) && tri(c, f, i));
+  }
+
+private:
+  // If given an integer (k), returns 2*k
+  // If given a DiracSpinor, F, returns 2*j [F.twoj()]
+  template <class A>
+  static int twojk(const A &a) {
+    if constexpr (std::is_same_v<A, DiracSpinor>) {
+      return a.twoj();
+    } else {
+      static_assert(std::is_same_v<A, int>);
+      return 2 * a;
+    }
+  }
+};
+
+} // namespace Angular
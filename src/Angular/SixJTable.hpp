@@ -2,11 +2,9 @@
 #include "Angular/Wigner369j.hpp"
 #include "Wavefunction/DiracSpinor.hpp" // for 'magic' 6J symbols
 #include <algorithm>
-#include <cassert>
+#include <cmath>
 #include <cstdint>
-#include <cstring>
-#include <iostream>
-#include <unordered_map>
+#include <limits>
 #include <vector>
 
 // XXX Note: This is significantly faster if implemented in header file, not
@@ -19,13 +17,30 @@ namespace Angular {
 //! Lookup table for Wigner 6J symbols.
 /*! @details
 Note: functions all called with 2*j and 2*k (ensure j integer)
-Makes use of symmetry (but not completely, not every stores symbol is unique).
+
+Makes full use of the 144 (classical + Regge) symmetries: each unique symbol is
+stored exactly once, in a dense array. A 6j symbol {a b c \ d e f} depends only
+on the four triad sums, alpha_i = {a+b+c, a+e+f, d+b+f, d+e+c}/2, and the three
+sums beta_j = {a+b+d+e, b+c+e+f, c+a+f+d}/2, and is symmetric under any
+permutation of the alpha's and of the beta's. With these sorted (A1>=..>=A4,
+B1>=B2>=B3), the six numbers
+  S=B3-A1 <= B=B3-A2 <= T=B3-A3 <= X=B3-A4 <= L=B2-A4 <= E=B1-A4
+are non-negative (triangle conditions), uniquely specify the symbol, and form a
+non-decreasing chain; the array index is the rank of this chain (combinatorial
+number system). A lookup is thus a few integer operations and an array load.
+Each of these is a triangle excess (e.g., a+b-c), so E <= max(2j).
+
+Ordered by E, so extending the table only appends. The symbols are calculated
+(in parallel) from the Racah formula, with consecutive terms of the sum
+generated by recursion.
 */
 class SixJTable {
 private:
-  std::unordered_map<uint64_t, double> m_data{};
+  std::vector<double> m_data{};
   int m_max_2j_k{-1};
-  static auto s(int i) { return static_cast<uint8_t>(i); };
+  int m_max_E{-1};
+  // C(x+k-1, k), k=6,5,4,3,2, for x in [0,max_E]: used by index()
+  std::vector<uint64_t> m_binom{};
 
 public:
   //! Default contructor: creates empty table
@@ -43,7 +58,7 @@ public:
   //! Returns maximum element (k or 2j) of tables [max(k) = 2*max(j) = max(2j)]
   int max_2jk() const { return m_max_2j_k; }
 
-  //! Returns number of non-zero symbols stored
+  //! Returns number of (unique) symbols stored
   std::size_t size() const { return m_data.size(); }
 
   //----------------------------------------------------------------------------
@@ -51,10 +66,8 @@ public:
   //! @details Note: If requesting a 6J symbol beyond what is stored, will
   //! return 0 (without warning)
   inline double get_2(int a, int b, int c, int d, int e, int f) const {
-    if (Angular::sixj_zeroQ(a, b, c, d, e, f))
-      return 0.0;
-    const auto it = m_data.find(normal_order(a, b, c, d, e, f));
-    return (it == m_data.cend()) ? 0.0 : it->second;
+    const auto i = index(a, b, c, d, e, f);
+    return i < m_data.size() ? m_data[i] : 0.0;
   }
 
   //! Return "magic" 6j. Pass in either integer (for k), or DiracSpinor, F.
@@ -71,8 +84,7 @@ public:
   //! Checks if given 6j symbol is in table (note: may not be in table because
   //! it's zero)
   bool contains(int a, int b, int c, int d, int e, int f) const {
-    const auto it = m_data.find(normal_order(a, b, c, d, e, f));
-    return (it != m_data.cend());
+    return index(a, b, c, d, e, f) < m_data.size();
   }
 
   //----------------------------------------------------------------------------
@@ -82,26 +94,26 @@ public:
     if (max_2j_k <= m_max_2j_k)
       return;
 
-    // Calculate all new *unique* 6J symbols:
-    // Take advantage of symmetries, to only calc those that are needed.
-    // We define a = min(a,b,c,d,e,f), b=min(b,d,e,f) => unique 6j symbol
-    // in "normal" order
-    const auto max_2k = 2 * max_2j_k;
-    for (int a = 0; a <= max_2k; ++a) {
-      auto a0 = a; // std::max(min_2jk, a);
-      for (int b = a0; b <= max_2k; ++b) {
-        for (int c = b; c <= max_2k; ++c) {
-          for (int d = a0; d <= max_2k; ++d) { // note: different!
-            for (int e = b; e <= max_2k; ++e) {
-              for (int f = b; f <= max_2k; ++f) {
-                if (Angular::sixj_zeroQ(a, b, c, d, e, f))
-                  continue;
-                if (contains(a, b, c, d, e, f))
-                  continue;
-                const auto sj = Angular::sixj_2(a, b, c, d, e, f);
-                if (std::abs(sj) > 1.0e-16) {
-                  m_data[normal_order(a, b, c, d, e, f)] = sj;
-                }
+    // All symbols with max(2j) <= 2*max_2j_k have E <= 2*max_2j_k
+    const auto max_E = 2 * max_2j_k;
+    m_data.resize(rank(max_E + 1, 0, 0, 0, 0, 0));
+
+    // Factorials, up to largest required: (B3 + 1)!, B3 <= 4E
+    std::vector<long double> fact(std::size_t(4 * max_E + 2), 1.0L);
+    for (std::size_t n = 1; n < fact.size(); ++n) {
+      fact[n] = fact[n - 1] * (long double)n;
+    }
+
+    // Only new symbols: those with E > previous max E
+    for (int E = m_max_E + 1; E <= max_E; ++E) {
+#pragma omp parallel for schedule(dynamic)
+      for (int L = 0; L <= E; ++L) {
+        for (int X = 0; X <= L; ++X) {
+          for (int T = 0; T <= X; ++T) {
+            for (int B = 0; B <= T; ++B) {
+              for (int S = 0; S <= B; ++S) {
+                m_data[rank(E, L, X, T, B, S)] =
+                    racah(E, L, X, T, B, S, fact);
               }
             }
           }
@@ -109,107 +121,109 @@ public:
       }
     }
 
-    // update max 2k
+    m_binom.clear();
+    for (const auto k : {6, 5, 4, 3, 2}) {
+      for (int x = 0; x <= max_E; ++x) {
+        m_binom.push_back(rank(k == 6 ? x : 0, k == 5 ? x : 0, k == 4 ? x : 0,
+                               k == 3 ? x : 0, k == 2 ? x : 0, 0));
+      }
+    }
+    m_max_E = max_E;
     m_max_2j_k = max_2j_k;
   }
 
 private:
   //----------------------------------------------------------------------------
-  inline static auto make_key(uint8_t a, uint8_t b, uint8_t c, uint8_t d,
-                              uint8_t e, uint8_t f) {
-    static_assert(sizeof(uint64_t) >= 6 * sizeof(uint8_t));
-    uint64_t key = 0;
-    const auto pk = reinterpret_cast<uint8_t *>(&key);
-    std::memcpy(pk, &a, sizeof(uint8_t));
-    std::memcpy(pk + 1, &b, sizeof(uint8_t));
-    std::memcpy(pk + 2, &c, sizeof(uint8_t));
-    std::memcpy(pk + 3, &d, sizeof(uint8_t));
-    std::memcpy(pk + 4, &e, sizeof(uint8_t));
-    std::memcpy(pk + 5, &f, sizeof(uint8_t));
-    return key;
-  }
-  inline static auto make_key(int a, int b, int c, int d, int e, int f) {
-    return make_key(s(a), s(b), s(c), s(d), s(e), s(f));
+  // Position of chain S<=B<=T<=X<=L<=E in dense (E-major) order:
+  // sum of binomials C(x+k-1, k) = number of chains of length k with max < x
+  static constexpr uint64_t rank(int E, int L, int X, int T, int B, int S) {
+    const auto e = uint64_t(E), l = uint64_t(L), x = uint64_t(X);
+    const auto t = uint64_t(T), b = uint64_t(B);
+    return e * (e + 1) * (e + 2) * (e + 3) * (e + 4) * (e + 5) / 720 +
+           l * (l + 1) * (l + 2) * (l + 3) * (l + 4) / 120 +
+           x * (x + 1) * (x + 2) * (x + 3) / 24 + t * (t + 1) * (t + 2) / 6 +
+           b * (b + 1) / 2 + uint64_t(S);
   }
 
   //----------------------------------------------------------------------------
-  inline static auto normal_order_level2(int a, int b, int c, int d, int e,
-                                         int f) {
-    // note: 'a' must be minimum!
-    // assert(a == std::min({a, b, c, d, e, f})); // remove
-    // {a,b,c|d,e,f} = {a,c,b|d,f,e} = {a,e,f|d,b,c} = {a,f,e|d,c,b}
-    const auto min_bcef = std::min({b, c, e, f});
-
-    if (min_bcef == b) {
-      return make_key(s(a), s(b), s(c), s(d), s(e), s(f));
-    } else if (min_bcef == c) {
-      return make_key(s(a), s(c), s(b), s(d), s(f), s(e));
-    } else if (min_bcef == e) {
-      return make_key(s(a), s(e), s(f), s(d), s(b), s(c));
-    } else if (min_bcef == f) {
-      return make_key(s(a), s(f), s(e), s(d), s(c), s(b));
-    }
-    assert(false && "Fatal error 170: unreachable");
+  // Returns index of {a,b,c,d,e,f} into m_data; out-of-range if symbol is zero
+  // by selection rules (or not stored)
+  inline uint64_t index(int a, int b, int c, int d, int e, int f) const {
+    constexpr auto zero = std::numeric_limits<uint64_t>::max();
+    int A[4] = {(a + b + c) / 2, (a + e + f) / 2, (d + b + f) / 2,
+                (d + e + c) / 2};
+    int Bt[3] = {(a + b + d + e) / 2, (b + c + e + f) / 2,
+                 (c + a + f + d) / 2};
+    // Zero unless: triads have integer sums, all beta_j - alpha_i >= 0
+    // (triangle conditions), and no j's are negative. nb: single branch
+    const auto odd = (a + b + c) | (a + e + f) | (d + b + f) | (d + e + c);
+    const auto max_A = std::max(std::max(A[0], A[1]), std::max(A[2], A[3]));
+    const auto min_B = std::min(std::min(Bt[0], Bt[1]), Bt[2]);
+    if ((odd & 1) | (min_B < max_A) | ((a | b | c | d | e | f) < 0))
+      return zero;
+    // sorting networks: A[0] >= A[1] >= A[2] >= A[3], Bt[0] >= Bt[1] >= Bt[2]
+    const auto sort2 = [](int &x, int &y) {
+      const auto max = std::max(x, y);
+      y = std::min(x, y);
+      x = max;
+    };
+    sort2(A[0], A[1]);
+    sort2(A[2], A[3]);
+    sort2(A[0], A[2]);
+    sort2(A[1], A[3]);
+    sort2(A[1], A[2]);
+    sort2(Bt[0], Bt[1]);
+    sort2(Bt[1], Bt[2]);
+    sort2(Bt[0], Bt[1]);
+    const auto S = Bt[2] - A[0];
+    const auto E = Bt[0] - A[3];
+    if (E > m_max_E)
+      return zero;
+    const auto E0 = std::size_t(m_max_E + 1);
+    const auto *C = m_binom.data();
+    return C[std::size_t(E)] + C[E0 + std::size_t(Bt[1] - A[3])] +
+           C[2 * E0 + std::size_t(Bt[2] - A[3])] +
+           C[3 * E0 + std::size_t(Bt[2] - A[2])] +
+           C[4 * E0 + std::size_t(Bt[2] - A[1])] + std::uint64_t(S);
   }
 
   //----------------------------------------------------------------------------
-  static uint64_t normal_order(int a, int b, int c, int d, int e, int f) {
-    // returns unique "normal ordering" of {a,b,c,d,e,f}->{i,j,k,l,m,n}
-
-    // auto t11 = make_key(a, b, c, d, e, f);
-    // auto t21 = make_key(a, c, b, d, f, e);
-    // auto t31 = make_key(b, a, c, e, d, f);
-    // auto t41 = make_key(b, c, a, e, f, d);
-    // auto t51 = make_key(c, b, a, f, e, d);
-    // auto t61 = make_key(c, a, b, f, d, e);
-    // auto t12 = make_key(a, e, f, d, b, c);
-    // auto t22 = make_key(a, f, e, d, c, b);
-    // auto t32 = make_key(b, d, f, e, a, c);
-    // auto t42 = make_key(b, f, d, e, c, a);
-    // auto t52 = make_key(c, e, d, f, b, a);
-    // auto t62 = make_key(c, d, e, f, a, b);
-    // auto t13 = make_key(d, b, f, a, e, c);
-    // auto t23 = make_key(d, c, e, a, f, b);
-    // auto t33 = make_key(e, a, f, b, d, c);
-    // auto t43 = make_key(e, c, d, b, f, a);
-    // auto t53 = make_key(f, a, e, c, d, b);
-    // auto t63 = make_key(f, b, d, c, e, a);
-    // auto t14 = make_key(d, e, c, a, b, f);
-    // auto t24 = make_key(d, f, b, a, c, e);
-    // auto t34 = make_key(e, d, c, b, a, f);
-    // auto t44 = make_key(e, f, a, b, c, d);
-    // auto t54 = make_key(f, e, a, c, b, d);
-    // auto t64 = make_key(f, d, b, c, a, e);
-    //
-    // return std::min({t11, t21, t31, t41, t51, t61, t12, t22,
-    //                  t32, t42, t52, t62, t13, t23, t33, t43,
-    //                  t53, t63, t14, t24, t34, t44, t54, t64});
-    // returns unique "normal ordering" of {a,b,c,d,e,f}->{i,j,k,l,m,n}
-    // where i = min{a,b,c,d,e,f}, j = min{b,c,e,f}
-
-    // nb: This is not quite correct, and leads to storing more 6J's than
-    // required. However, so long as we actually calculate all of them, it turns
-    // out this is faster.
-
-    const auto min = std::min({a, b, c, d, e, f});
-    //   {a,b,c|d,e,f} = {b,a,c|e,d,f} = {c,a,b|f,d,e}
-    // = {d,e,c|a,b,f} = {e,d,c|b,a,f} = {f,a,e|c,d,b}
-    // at next level, use also:
-    // {a,b,c|d,e,f} = {a,c,b|d,f,e} = {a,e,f|d,b,c} = {a,f,e|d,c,b}
-    if (min == a) {
-      return normal_order_level2(a, b, c, d, e, f);
-    } else if (min == b) {
-      return normal_order_level2(b, a, c, e, d, f);
-    } else if (min == c) {
-      return normal_order_level2(c, a, b, f, d, e);
-    } else if (min == d) {
-      return normal_order_level2(d, e, c, a, b, f);
-    } else if (min == e) {
-      return normal_order_level2(e, d, c, b, a, f);
-    } else if (min == f) {
-      return normal_order_level2(f, a, e, c, d, b);
+  // 6j symbol from the Racah formula, in terms of chain S<=B<=T<=X<=L<=E
+  static double racah(int E, int L, int X, int T, int B, int S,
+                      const std::vector<long double> &fact) {
+    // Reconstruct the (sorted) alpha's and beta's
+    const int B3 = S + B + T + L + E - X;
+    const int A[4] = {B3 - S, B3 - B, B3 - T, B3 - X};
+    const int Bt[3] = {E + A[3], L + A[3], B3};
+
+    // Product of the four triangle coeficients, Delta(abc)
+    long double delta = 1.0L;
+    for (const auto Ai : A) {
+      long double d2 = 1.0L / fact[std::size_t(Ai + 1)];
+      for (const auto Bj : Bt) {
+        d2 *= fact[std::size_t(Bj - Ai)];
+      }
+      delta *= std::sqrt(d2);
+    }
+
+    // Sum over z, from max(alpha) = A[0] to min(beta) = B3 (S+1 terms).
+    // First term, then: t(z+1)/t(z) = -(z+2)prod(B_j-z)/prod(z+1-A_i)
+    auto z = A[0];
+    long double term = fact[std::size_t(z + 1)];
+    for (const auto Ai : A)
+      term /= fact[std::size_t(z - Ai)];
+    for (const auto Bj : Bt)
+      term /= fact[std::size_t(Bj - z)];
+    if (z % 2 != 0)
+      term = -term;
+    long double sum = term;
+    for (; z < B3; ++z) {
+      term *= -(long double)(z + 2) * (Bt[0] - z) * (Bt[1] - z) * (Bt[2] - z);
+      term /= (long double)(z + 1 - A[0]) * (z + 1 - A[1]) * (z + 1 - A[2]) *
+              (z + 1 - A[3]);
+      sum += term;
     }
-    assert(false && "Fatal error 193: unreachable");
+    return double(delta * sum);
   }
 
   //----------------------------------------------------------------------------
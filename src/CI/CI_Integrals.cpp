@@ -1,15 +1,31 @@
 #include "CI_Integrals.hpp"
 #include "CSF.hpp"
+#include "Angular/RecouplingTable.hpp"
 #include "Coulomb/Coulomb.hpp"
 #include "HF/Breit.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "MBPT/CorrelationPotential.hpp"
 #include "MBPT/Sigma2.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
+#include <array>
 #include <vector>
 
 namespace CI {
 
+namespace {
+// 6j symbols in the CSF angular factors: these are requested many times over
+// (for each CSF pair); calculated once, and shared between threads
+const Angular::RecouplingTable<6> s_sixj([](const std::array<int, 6> &t) {
+  return Angular::sixj_2(t[0], t[1], t[2], t[3], t[4], t[5]);
+});
+
+double sixj_cached(int a, int b, int c, int d, int e, int f) {
+  if (Angular::sixj_zeroQ(a, b, c, d, e, f))
+    return 0.0;
+  return s_sixj.get_2(a, b, c, d, e, f);
+}
+} // namespace
+
 //==============================================================================
 // Calculates the anti-symmetrised Coulomb integral for 2-particle states:
 // C1*C2*(g_abcd-g_abdc), where Cs are C.G. coefficients
@@ -35,7 +51,7 @@ double CSF2_Coulomb(const Coulomb::QkTable &qk, DiracSpinor::Index v,
   // Direct part:
   const auto [k0, k1] = Coulomb::k_minmax_Q(kv, kw, kx, ky);
   for (int k = k0; k <= k1; k += 2) {
-    const auto sjs = Angular::sixj_2(tjv, tjw, twoJ, tjy, tjx, 2 * k);
+    const auto sjs = sixj_cached(tjv, tjw, twoJ, tjy, tjx, 2 * k);
     if (sjs == 0.0)
       continue;
     const auto qk_abcd = qk.Q(k, v, w, x, y);
@@ -60,7 +76,7 @@ double CSF2_Coulomb(const Coulomb::QkTable &qk, DiracSpinor::Index v,
   // Exchange part:
   const auto [l0, l1] = Coulomb::k_minmax_Q(kv, kw, ky, kx);
   for (int k = l0; k <= l1; k += 2) {
-    const auto sjs = Angular::sixj_2(tjv, tjw, twoJ, tjx, tjy, 2 * k);
+    const auto sjs = sixj_cached(tjv, tjw, twoJ, tjx, tjy, 2 * k);
     if (sjs == 0.0)
       continue;
     const auto qk_abdc = qk.Q(k, v, w, y, x);
@@ -89,7 +105,7 @@ double CSF2_Sigma2(const Coulomb::LkTable &Sk, DiracSpinor::Index v,
   // Direct part:
   const auto [k0, k1] = MBPT::k_minmax_S(tjv, tjw, tjx, tjy);
   for (int k = k0; k <= k1; ++k) {
-    const auto sjs = Angular::sixj_2(tjv, tjw, twoJ, tjy, tjx, 2 * k);
+    const auto sjs = sixj_cached(tjv, tjw, twoJ, tjy, tjx, 2 * k);
     if (sjs == 0.0)
       continue;
     // const auto Sk_abcd = MBPT::Sk_vwxy(k, a, b, c, d, qk, core, excited, SixJ);
@@ -113,7 +129,7 @@ double CSF2_Sigma2(const Coulomb::LkTable &Sk, DiracSpinor::Index v,
   // Exchange part:
   const auto [l0, l1] = MBPT::k_minmax_S(tjv, tjw, tjy, tjx);
   for (int k = l0; k <= l1; ++k) {
-    const auto sjs = Angular::sixj_2(tjv, tjw, twoJ, tjx, tjy, 2 * k);
+    const auto sjs = sixj_cached(tjv, tjw, twoJ, tjx, tjy, 2 * k);
     if (sjs == 0.0)
       continue;
     // const auto Sk_abdc = MBPT::Sk_vwxy(k, a, b, d, c, qk, core, excited, SixJ);
@@ -145,7 +161,7 @@ double CSF2_Breit(const Coulomb::WkTable &Bk, DiracSpinor::Index v,
   // Direct part:
   const auto [k0, k1] = HF::Breit::k_minmax_tj(tjv, tjw, tjx, tjy);
   for (int k = k0; k <= k1; ++k) {
-    const auto sjs = Angular::sixj_2(tjv, tjw, twoJ, tjy, tjx, 2 * k);
+    const auto sjs = sixj_cached(tjv, tjw, twoJ, tjy, tjx, 2 * k);
     if (sjs == 0.0)
       continue;
     const auto bk_abcd = Bk.Q(k, v, w, x, y);
@@ -164,7 +180,7 @@ double CSF2_Breit(const Coulomb::WkTable &Bk, DiracSpinor::Index v,
   // Exchange part:
   const auto [l0, l1] = HF::Breit::k_minmax_tj(tjv, tjw, tjy, tjx);
   for (int k = l0; k <= l1; ++k) {
-    const auto sjs = Angular::sixj_2(tjv, tjw, twoJ, tjx, tjy, 2 * k);
+    const auto sjs = sixj_cached(tjv, tjw, twoJ, tjx, tjy, 2 * k);
     if (sjs == 0.0)
       continue;
     const auto bk_abdc = Bk.Q(k, v, w, y, x);
@@ -487,25 +503,25 @@ double RME_CSF2(const CI::CSF2 &X, int twoJX, const CI::CSF2 &V, int twoJV,
 
   double sum = 0.0;
   if (y == w) {
-    const auto sj = Angular::sixj_2(twoJX, twoJV, twok, tjv, tjx, tjw);
+    const auto sj = sixj_cached(twoJX, twoJV, twok, tjv, tjx, tjw);
     const auto t = h.getv(x, v);
     const auto s = Angular::neg1pow_2(tjw + tjx + twoJV);
     sum += f * sj * t * s;
   }
   if (y == v) {
-    const auto sj = Angular::sixj_2(twoJX, twoJV, twok, tjw, tjx, tjv);
+    const auto sj = sixj_cached(twoJX, twoJV, twok, tjw, tjx, tjv);
     const auto t = h.getv(x, w);
     const auto s = Angular::neg1pow_2(tjw + tjx);
     sum += f * sj * t * s;
   }
   if (x == w) {
-    const auto sj = Angular::sixj_2(twoJX, twoJV, twok, tjv, tjy, tjw);
+    const auto sj = sixj_cached(twoJX, twoJV, twok, tjv, tjy, tjw);
     const auto t = h.getv(y, v);
     const auto s = Angular::neg1pow_2(twoJX + twoJV + 2);
     sum += f * sj * t * s;
   }
   if (x == v) {
-    const auto sj = Angular::sixj_2(twoJX, twoJV, twok, tjw, tjy, tjv);
+    const auto sj = sixj_cached(twoJX, twoJV, twok, tjw, tjy, tjv);
     const auto t = h.getv(y, w);
     const auto s = Angular::neg1pow_2(tjw + tjv + twoJX);
     sum += f * sj * t * s;
@@ -5,7 +5,9 @@
 #include "Coulomb/Coulomb.hpp"
 #include "DiracOperator/DiracOperator.hpp"
 #include "ExternalField/calcMatrixElements.hpp"
+#include "IO/ChronoTimer.hpp"
 #include "IO/InputBlock.hpp"
+#include "IO/Profile.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "MBPT/CorrelationPotential.hpp"
 #include "MBPT/Sigma2.hpp"
@@ -432,13 +434,17 @@ PsiJPi run_CI(const std::vector<DiracSpinor> &ci_sp_basis, int twoJ, int parity,
   // Construct the CI matrix:
   const auto br_ptr = !Bk.emptyQ() ? &Bk : nullptr;
   const auto s2_ptr = include_Sigma2 ? &Sk : nullptr;
-  const auto Hci = CI::construct_Hci(psi, h1, qk, br_ptr, s2_ptr);
+  const auto Hci = [&]() {
+    IO::Profile::Region profile("CI: build H");
+    return CI::construct_Hci(psi, h1, qk, br_ptr, s2_ptr);
+  }();
 
   //----------------------------------------------------------------------------
 
   fmt::print(outstream, "Find first {} solutions\n", num_solutions);
   {
     IO::ChronoTimer t2("");
+    IO::Profile::Region profile("CI: diagonalise");
     psi.solve(Hci, num_solutions);
     outstream << "Eigenvalues: T = " << t2.reading_str() << "\n";
   }
@@ -373,6 +373,81 @@ TEST_CASE("Coulomb: yk,Rk formulas", "[Coulomb][unit]") {
   }
 }
 
+//==============================================================================
+// Kernels only loop over the overlapping support [min_pt, max_pt) of the
+// spinors. Check against the same spinors with support set to the full grid
+TEST_CASE("Coulomb: range-restricted kernels", "[Coulomb][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "Coulomb: range-restricted kernels\n";
+
+  const auto radial_grid = std::make_shared<const Grid>(
+      GridParameters{500, 1.0e-4, 250.0, 50.0, GridType::loglinear});
+  const auto num_points = radial_grid->num_points();
+
+  // Spinors with truncated (and different) support:
+  std::vector<DiracSpinor> orbs;
+  for (int kappa : {-1, 1, -2, 2, -3}) {
+    const auto l = Angular::l_k(kappa);
+    for (int n = l + 1; n <= l + 2; ++n) {
+      auto Fn = DiracSpinor::exactHlike(n, kappa, radial_grid, 1.0);
+      Fn.min_pt() = std::size_t(5 * n + 3 * l);
+      Fn.max_pt() = num_points - std::size_t(40 * n + 10 * l);
+      Fn.zero_boundaries();
+      orbs.push_back(Fn);
+    }
+  }
+  // Identical, but with 'support' covering full grid
+  auto orbs_full = orbs;
+  for (auto &Fn : orbs_full) {
+    Fn.min_pt() = 0;
+    Fn.max_pt() = num_points;
+  }
+
+  double worst_Rk = 0.0;
+  for (std::size_t a = 0; a < orbs.size(); ++a) {
+    for (std::size_t b = 0; b < orbs.size(); ++b) {
+      const auto &Fa = orbs[a];
+      const auto &Fb = orbs[b];
+      const auto &Fa0 = orbs_full[a];
+      const auto &Fb0 = orbs_full[b];
+      const auto [k0, ki] = Angular::kminmax_Ck(Fa.kappa(), Fb.kappa());
+      for (int k = k0; k <= ki; k += 2) {
+        // y^k_ab is identical (only zeros are skipped)
+        const auto yk = Coulomb::yk_ab(k, Fa, Fb);
+        const auto yk0 = Coulomb::yk_ab(k, Fa0, Fb0);
+        REQUIRE(yk == yk0);
+        const auto maxi = std::min(Fa.max_pt(), Fb.max_pt()) - 7;
+        const auto ykm = Coulomb::yk_ab(k, Fa, Fb, maxi);
+        const auto ykm0 = Coulomb::yk_ab(k, Fa0, Fb0, maxi);
+        REQUIRE(ykm == ykm0);
+
+        // R^k_vbcd: identical
+        const auto Rkv = Coulomb::Rkv_bcd(Fa.kappa(), Fb, yk);
+        const auto Rkv0 = Coulomb::Rkv_bcd(Fa.kappa(), Fb0, yk0);
+        REQUIRE(Rkv.f() == Rkv0.f());
+        REQUIRE(Rkv.g() == Rkv0.g());
+
+        // R^k_abcd: equal to within rounding (integration order differs)
+        const auto Rk = Coulomb::Rk_abcd(Fa, Fb, yk);
+        const auto Rk0 = Coulomb::Rk_abcd(Fa0, Fb0, yk0);
+        worst_Rk = std::max(worst_Rk, std::abs(Rk - Rk0));
+      }
+    }
+  }
+  std::cout << "Rk: " << worst_Rk << "\n";
+  REQUIRE(worst_Rk < 1.0e-14);
+
+  // No overlap: y^k_ab = 0
+  auto Fa = orbs.front();
+  auto Fb = orbs.front();
+  Fa.max_pt() = 100;
+  Fb.min_pt() = 100;
+  Fa.zero_boundaries();
+  Fb.zero_boundaries();
+  const auto yk = Coulomb::yk_ab(0, Fa, Fb);
+  REQUIRE(yk == std::vector<double>(num_points, 0.0));
+}
+
 //==============================================================================
 TEST_CASE("Coulomb: yk tables", "[Coulomb][yktable][unit]") {
   std::cout << "\n----------------------------------------\n";
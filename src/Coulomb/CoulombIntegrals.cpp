@@ -13,9 +13,9 @@
 namespace Coulomb {
 
 //==============================================================================
-template <int k>
-static inline void yk_ijk_impl(const int l, const DiracSpinor &Fa,
-                               const DiracSpinor &Fb, std::vector<double> &vabk,
+template <int k, typename Spinor>
+static inline void yk_ijk_impl(const int l, const Spinor &Fa, const Spinor &Fb,
+                               std::vector<double> &vabk,
                                const std::size_t maxi)
 // Calculalates y^k_ab screening function.
 // Note: is symmetric: y_ab = y_ba
@@ -63,30 +63,57 @@ static inline void yk_ijk_impl(const int l, const DiracSpinor &Fa,
     return NumCalc::dq_inv * NumCalc::cq[num_points - i - 1];
   };
 
+  const auto *fa = Fa.f().data();
+  const auto *ga = Fa.g().data();
+  const auto *fb = Fb.f().data();
+  const auto *gb = Fb.g().data();
+  const auto *drduor = gr.drduor().data();
   const auto ff = [&](std::size_t i) {
-    return (Fa.f(i) * Fb.f(i) + Fa.g(i) * Fb.g(i)) * w(i) * gr.drduor(i);
+    return (fa[i] * fb[i] + ga[i] * gb[i]) * w(i) * drduor[i];
   };
   const auto &r = gr.r();
 
+  // rho(r) = Fa*Fb is only non-zero on the overlap [i0, bmax) of the two
+  // spinors. Outside that, A and B are just propagated (rho terms are zero)
+  const auto i0 = std::max(Fa.min_pt(), Fb.min_pt());
+  const auto bmax = std::min({Fa.max_pt(), Fb.max_pt(), num_points});
+
+  if (i0 >= bmax) {
+    // no overlap: y^k_ab = 0 everywhere
+    std::fill(vabk.begin(), vabk.end(), 0.0);
+    return;
+  }
+
   double Ax = 0.0, Bx = 0.0;
 
-  vabk[0] = 0.0;
-  for (std::size_t i = 1; i < irmax; ++i) {
+  // A(r) = 0 for r <= r[i0]
+  const auto iA0 = std::min(i0 + 1, irmax);
+  const auto iA1 = std::max(iA0, std::min(bmax + 1, irmax));
+  for (std::size_t i = 0; i < iA0; ++i) {
+    vabk[i] = 0.0;
+  }
+  for (std::size_t i = iA0; i < iA1; ++i) {
     const auto rat = r[i - 1] / r[i];
     Ax = (Ax + ff(i - 1)) * (rat * powk(rat));
     vabk[i] = Ax * du;
   }
+  for (std::size_t i = iA1; i < irmax; ++i) {
+    const auto rat = r[i - 1] / r[i];
+    Ax = Ax * (rat * powk(rat));
+    vabk[i] = Ax * du;
+  }
 
-  const auto bmax = std::min({Fa.max_pt(), Fb.max_pt(), num_points});
-  // nb bmax may be num_points
-  const auto rbmax =
-      bmax == num_points ? r.back() + gr.drdu().back() * du : r[bmax];
-  Bx = Bx * powk(r[bmax - 1] / rbmax) + ff(bmax - 1);
+  // B(r) = 0 for r >= r[bmax]
+  Bx = ff(bmax - 1);
   vabk[bmax - 1] += Bx * du;
-  for (auto i = bmax - 1; i >= 1; --i) {
+  for (auto i = bmax - 1; i > i0; --i) {
     Bx = Bx * powk(r[i - 1] / r[i]) + ff(i - 1);
     vabk[i - 1] += Bx * du;
   }
+  for (auto i = i0; i >= 1; --i) {
+    Bx = Bx * powk(r[i - 1] / r[i]);
+    vabk[i - 1] += Bx * du;
+  }
 
   for (std::size_t i = irmax; i < num_points; i++) {
     vabk[i] = 0.0;
@@ -184,8 +211,9 @@ std::vector<double> yk_ab(const int k, const DiracSpinor &Fa,
 }
 
 //------------------------------------------------------------------------------
-void yk_ab(const int k, const DiracSpinor &Fa, const DiracSpinor &Fb,
-           std::vector<double> &vabk, const std::size_t maxi) {
+template <typename Spinor>
+static void yk_ab_impl(const int k, const Spinor &Fa, const Spinor &Fb,
+                       std::vector<double> &vabk, const std::size_t maxi) {
 
   // faster method to calculate r^k
   if (k == 0)
@@ -214,6 +242,18 @@ void yk_ab(const int k, const DiracSpinor &Fa, const DiracSpinor &Fb,
     yk_ijk_impl<-1>(k, Fa, Fb, vabk, maxi);
 }
 
+//------------------------------------------------------------------------------
+void yk_ab(const int k, const DiracSpinor &Fa, const DiracSpinor &Fb,
+           std::vector<double> &vabk, const std::size_t maxi) {
+  yk_ab_impl(k, Fa, Fb, vabk, maxi);
+}
+
+//------------------------------------------------------------------------------
+void yk_ab(const int k, const OrbitalSet::View &Fa, const OrbitalSet::View &Fb,
+           std::vector<double> &vabk, const std::size_t maxi) {
+  yk_ab_impl(k, Fa, Fb, vabk, maxi);
+}
+
 //==============================================================================
 template <int k, int pm>
 static inline void Breit_abk_impl(const int l, const DiracSpinor &Fa,
@@ -329,8 +369,10 @@ DiracSpinor Rkv_bcd(const int kappa_a, const DiracSpinor &Fc,
   auto out = DiracSpinor(0, kappa_a, Fc.grid_sptr());
   out.min_pt() = Fc.min_pt();
   out.max_pt() = Fc.max_pt();
-  out.f() = qip::multiply(Fc.f(), ykbd);
-  out.g() = qip::multiply(Fc.g(), ykbd);
+  for (auto i = out.min_pt(); i < out.max_pt(); ++i) {
+    out.f(i) = Fc.f(i) * ykbd[i];
+    out.g(i) = Fc.g(i) * ykbd[i];
+  }
   return out;
 }
 //------------------------------------------------------------------------------
@@ -455,17 +497,28 @@ DiracSpinor Pkv_bcd(const int k, int kappa_a, const DiracSpinor &Fb,
   const auto min_twol =
       std::max(std::abs(Fd.twoj() - tja), std::abs(Fc.twoj() - Fb.twoj()));
   const auto max_twol = std::min(Fd.twoj() + tja, Fc.twoj() + Fb.twoj());
+  // re-used for each l:
+  std::vector<double> ylbc(Fb.grid().num_points());
   for (int tl = min_twol; tl <= max_twol; tl += 2) {
-    if (!Angular::Ck_kk_SR(tl / 2, Fb.kappa(), Fc.kappa()) ||
-        !Angular::Ck_kk_SR(tl / 2, kappa_a, Fd.kappa()))
+    const auto l = tl / 2;
+    if (!Angular::Ck_kk_SR(l, Fb.kappa(), Fc.kappa()) ||
+        !Angular::Ck_kk_SR(l, kappa_a, Fd.kappa()))
       continue;
     const auto sixj =
         Angular::sixj_2(Fc.twoj(), tja, 2 * k, Fd.twoj(), Fb.twoj(), tl);
     if (sixj == 0)
       continue;
-    out += sixj * Qkv_bcd(tl / 2, kappa_a, Fb, Fd, Fc);
+    // out += sixj * Qkv_bcd(l, kappa_a, Fb, Fd, Fc), without temporaries:
+    const auto tCad = Angular::tildeCk_kk(l, kappa_a, Fd.kappa());
+    const auto tCbc = Angular::tildeCk_kk(l, Fb.kappa(), Fc.kappa());
+    if (Angular::zeroQ(tCbc) || Angular::zeroQ(tCad))
+      continue;
+    const auto m1tl = Angular::evenQ(l) ? 1 : -1;
+    yk_ab(l, Fb, Fc, ylbc, Fd.max_pt());
+    out.add(sixj * (m1tl * tCad * tCbc), ylbc, Fd);
   }
-  return (tkp1 * out);
+  out *= tkp1;
+  return out;
 }
 
 //------------------------------------------------------------------------------
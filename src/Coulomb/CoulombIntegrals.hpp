@@ -1,6 +1,7 @@
 #pragma once
 #include "Angular/Angular.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
+#include "Wavefunction/OrbitalSet.hpp"
 #include <optional>
 #include <vector>
 
@@ -15,6 +16,10 @@ std::vector<double> yk_ab(const int k, const DiracSpinor &Fa,
 void yk_ab(const int k, const DiracSpinor &Fa, const DiracSpinor &Fb,
            std::vector<double> &ykab, const std::size_t maxi = 0);
 
+//! Overload: for orbitals stored in OrbitalSet (contiguous storage)
+void yk_ab(const int k, const OrbitalSet::View &Fa, const OrbitalSet::View &Fb,
+           std::vector<double> &ykab, const std::size_t maxi = 0);
+
 //! Breit b^k function: (0,r) and (r,inf) part stored sepperately (in/out)
 void bk_ab(const int k, const DiracSpinor &Fa, const DiracSpinor &Fb,
            std::vector<double> &b0, std::vector<double> &binf,
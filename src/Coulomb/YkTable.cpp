@@ -2,9 +2,12 @@
 #include "Angular/CkTable.hpp"
 #include "Angular/SixJTable.hpp"
 #include "Coulomb/CoulombIntegrals.hpp"
+#include "IO/Profile.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
+#include "Wavefunction/OrbitalSet.hpp"
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <unordered_map>
 #include <vector>
 
@@ -16,6 +19,7 @@ void YkTable::calculate(const std::vector<DiracSpinor> &a_orbs,
   // note: make use of the symmetries: force a<=b
   // Note: we RE-calculate all integrals, and calculate any new ones.
   // do not use this to 'extend' the Yab table
+  IO::Profile::Region profile("Yk table");
 
   const auto max_2j =
       std::max(DiracSpinor::max_tj(a_orbs), DiracSpinor::max_tj(b_orbs));
@@ -26,17 +30,26 @@ void YkTable::calculate(const std::vector<DiracSpinor> &a_orbs,
   allocate_space(a_orbs, b_orbs);
 
   const auto a_is_b = (&a_orbs == &b_orbs);
+  if (a_orbs.empty() || b_orbs.empty())
+    return;
+
+  // Copy orbitals into contiguous storage: inner loops run over many pairs
+  const OrbitalSet a_set(a_orbs);
+  const OrbitalSet b_set =
+      a_is_b ? OrbitalSet(a_set.grid_sptr()) : OrbitalSet(b_orbs);
+  const auto &b_set_ref = a_is_b ? a_set : b_set;
 
 #pragma omp parallel for
   for (auto ia = 0ul; ia < a_orbs.size(); ++ia) {
     const auto &a = a_orbs[ia];
-    for (const auto &b : b_orbs) {
+    for (auto ib = 0ul; ib < b_orbs.size(); ++ib) {
+      const auto &b = b_orbs[ib];
       if (a_is_b && b > a)
         continue;
       const auto [k0, kI] = k_minmax_Ck(a, b);
       for (auto k = k0; k <= kI; k += 2) {
         auto &ykab = get_ref(k, a, b);
-        Coulomb::yk_ab(k, a, b, ykab);
+        Coulomb::yk_ab(k, a_set[ia], b_set_ref[ib], ykab);
       }
     }
   }
@@ -175,28 +188,49 @@ double YkTable::W(const int k, const DiracSpinor &Fa, const DiracSpinor &Fb,
 DiracSpinor YkTable::Qkv_bcd(const int k, int kappa, const DiracSpinor &Fb,
                              const DiracSpinor &Fc,
                              const DiracSpinor &Fd) const {
-  assert(k >= 0 && "Check k and kappa");
   DiracSpinor Qkv{0, kappa, Fb.grid_sptr()};
-  const auto tCac = m_Ck.get_tildeCkab(k, kappa, Fc.kappa());
+  Qkv_bcd(&Qkv, k, Fb, Fc, Fd);
+  return Qkv;
+}
+
+//------------------------------------------------------------------------------
+void YkTable::Qkv_bcd(DiracSpinor *const Qkv, const int k,
+                      const DiracSpinor &Fb, const DiracSpinor &Fc,
+                      const DiracSpinor &Fd) const {
+  assert(k >= 0 && "Check k and kappa");
+  const auto tCac = m_Ck.get_tildeCkab(k, Qkv->kappa(), Fc.kappa());
   const auto tCbd = m_Ck.get_tildeCkab(k, Fb.kappa(), Fd.kappa());
   const auto tCC = tCbd * tCac;
-  if (tCC != 0.0) {
-    // const auto ylbc = get(l, Fb, Fc);
-    const auto ykbd = get(k, Fb, Fd);
-    assert(ykbd != nullptr && "YkTable::Qkv_bcd() called but don't have Y_bd");
-    Coulomb::Rkv_bcd(&Qkv, Fc, *ykbd);
-    const auto m1tk = Angular::evenQ(k) ? 1 : -1;
-    Qkv.scale(m1tk * tCC);
+  if (tCC == 0.0) {
+    Qkv->scale(0.0);
+    return;
   }
-  return Qkv;
+  const auto ykbd = get(k, Fb, Fd);
+  assert(ykbd != nullptr && "YkTable::Qkv_bcd() called but don't have Y_bd");
+  Coulomb::Rkv_bcd(Qkv, Fc, *ykbd);
+  const auto m1tk = Angular::evenQ(k) ? 1 : -1;
+  Qkv->scale(m1tk * tCC);
 }
 
 //==============================================================================
 DiracSpinor YkTable::Pkv_bcd(const int k, int kappa, const DiracSpinor &Fb,
                              const DiracSpinor &Fc, const DiracSpinor &Fd,
                              const std::vector<double> &f2k) const {
-  assert(k >= 0 && "Check k and kappa");
   DiracSpinor Pkv{0, kappa, Fb.grid_sptr()};
+  Pkv_bcd(&Pkv, k, Fb, Fc, Fd, f2k);
+  return Pkv;
+}
+
+//------------------------------------------------------------------------------
+void YkTable::Pkv_bcd(DiracSpinor *const Pkv, const int k,
+                      const DiracSpinor &Fb, const DiracSpinor &Fc,
+                      const DiracSpinor &Fd,
+                      const std::vector<double> &f2k) const {
+  assert(k >= 0 && "Check k and kappa");
+  Pkv->scale(0.0);
+  // nb: Pkv may be a re-used buffer; range is built up by add() below
+  Pkv->min_pt() = Fd.min_pt();
+  Pkv->max_pt() = Fd.max_pt();
 
   const auto fk = [&f2k](int l) {
     // nb: only screens l, k assumed done outside...
@@ -206,21 +240,27 @@ DiracSpinor YkTable::Pkv_bcd(const int k, int kappa, const DiracSpinor &Fb,
     return 1.0;
   };
 
+  const auto tja = Pkv->twoj();
   const auto tkp1 = 2 * k + 1;
-  const auto [l0, lI] = Coulomb::k_minmax_Q(Pkv, Fb, Fd, Fc);
+  const auto [l0, lI] = Coulomb::k_minmax_Q(*Pkv, Fb, Fd, Fc);
   for (int l = l0; l <= lI; l += 2) {
     const auto ylbc = get(l, Fb, Fc);
     assert(ylbc != nullptr && "YkTable::Pkv_bcd() called but don't have Y_bc");
 
-    const auto sj = fk(l) * m_6j.get_2(Fc.twoj(), Angular::twoj_k(kappa), 2 * k,
-                                       Fd.twoj(), Fb.twoj(), 2 * l);
+    const auto sj = fk(l) * m_6j.get_2(Fc.twoj(), tja, 2 * k, Fd.twoj(),
+                                       Fb.twoj(), 2 * l);
 
     if (Angular::zeroQ(sj))
       continue;
-    Pkv += sj * Qkv_bcd(l, Pkv.kappa(), Fb, Fd, Fc);
+    // Pkv += sj * Qkv_bcd(l, Pkv.kappa(), Fb, Fd, Fc), without temporaries:
+    const auto tCC = m_Ck.get_tildeCkab(l, Pkv->kappa(), Fd.kappa()) *
+                     m_Ck.get_tildeCkab(l, Fb.kappa(), Fc.kappa());
+    if (tCC == 0.0)
+      continue;
+    const auto m1tl = Angular::evenQ(l) ? 1 : -1;
+    Pkv->add(sj * (m1tl * tCC), *ylbc, Fd);
   }
-  Pkv *= tkp1;
-  return Pkv;
+  Pkv->scale(tkp1);
 }
 
 } // namespace Coulomb
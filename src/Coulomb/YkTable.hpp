@@ -100,6 +100,17 @@ public:
   Pkv_bcd(const int k, int kappa, const DiracSpinor &Fb, const DiracSpinor &Fc,
           const DiracSpinor &Fd, const std::vector<double> &f2k = {}) const;
 
+  //! As Qkv_bcd(), but writes result into existing spinor Qkv (kappa is
+  //! Qkv->kappa()). Avoids allocation: intended for re-used buffers.
+  void Qkv_bcd(DiracSpinor *const Qkv, const int k, const DiracSpinor &Fb,
+               const DiracSpinor &Fc, const DiracSpinor &Fd) const;
+
+  //! As Pkv_bcd(), but writes result into existing spinor Pkv (kappa is
+  //! Pkv->kappa()). Avoids allocation: intended for re-used buffers.
+  void Pkv_bcd(DiracSpinor *const Pkv, const int k, const DiracSpinor &Fb,
+               const DiracSpinor &Fc, const DiracSpinor &Fd,
+               const std::vector<double> &f2k = {}) const;
+
 private:
   // Allocates space for the Yk table, but does not calculate Yk. This is
   // because allocation cannot be done in parallel, but once allocation is done,
@@ -635,4 +635,238 @@ private:
     }
   }
 };
+
+//==============================================================================
+//! Solves N independent 2D systems of ODEs simultaneously ("lanes"), which
+//! share the same t grid and step size, using a K-step Adams-Moulton method.
+/*! @details
+This is the batched equivalent of ODESolver2D. It is used when many
+independent equations (e.g., the Dirac equation for several energies or
+kappas) must be integrated over the same grid. Each step advances all N lanes
+together; the inner loops are over the lane index, and are written so that
+they may be vectorised (SIMD) by the compiler.
+
+Unlike ODESolver2D, the derivative matrix is not a virtual DerivativeMatrix.
+Instead, DM is a "policy" type, whose (non-virtual) member functions are
+inlined at compile time. It must implement:
+
+```cpp
+  Y a(T t, std::size_t j) const;
+  Y b(T t, std::size_t j) const;
+  Y c(T t, std::size_t j) const;
+  Y d(T t, std::size_t j) const;
+```
+
+where j is the lane index (j < N). Only the homogeneous problem is solved (no
+inhomogeneous S term).
+
+Previous K values are stored in a ring buffer (to avoid shifting K*N values
+along each step): f(k) returns the lanes for the kth most recent point, with
+k=0 the newest.
+
+Example: solve y'' = -w_j^2 y for four different w_j at once
+
+```cpp
+  struct Oscillators {
+    std::array<double, 4> w2{1.0, 4.0, 9.0, 16.0};
+    double a(double, std::size_t) const { return 0.0; }
+    double b(double, std::size_t) const { return 1.0; }
+    double c(double, std::size_t j) const { return -w2[j]; }
+    double d(double, std::size_t) const { return 0.0; }
+  };
+  Oscillators D;
+  AdamsMoulton::BatchODESolver2D<6, 4, Oscillators, double> ode{0.001, &D};
+  ode.solve_initial_K(0.0, {0.0, 0.0, 0.0, 0.0}, {1.0, 1.0, 1.0, 1.0});
+  for (int i = 0; i < 100; ++i) {
+    ode.drive();
+  }
+```
+*/
+template <std::size_t K, std::size_t N, typename DM, typename T = std::size_t,
+          typename Y = double>
+class BatchODESolver2D {
+  static_assert(K > 0, "Order (K) for Adams method must be K>0");
+  static_assert(K <= K_max,
+                "Order (K) requested for Adams method too "
+                "large. Adams coefficients are implemented up to K_max-1 only");
+  static_assert(N > 0, "Must have at least one lane (N>0)");
+  static_assert(
+      is_complex_v<Y> || std::is_floating_point_v<Y>,
+      "Template parameter Y (function values and dt) must be floating point "
+      "or complex");
+
+public:
+  //! Values for each lane, at a single t
+  using Lanes = std::array<Y, N>;
+
+private:
+  // Stores the AM coefficients
+  static constexpr AM_Coefs<K> am{};
+  // step size:
+  Y m_dt;
+  // Pointer to the derivative matrix (policy)
+  const DM *m_D;
+  // Position (in ring buffers) of the most recent point
+  std::size_t m_newest{K - 1};
+  // Ring buffers: previous K values of f, g, df, dg (and t)
+  std::array<Lanes, K> m_f{}, m_g{}, m_df{}, m_dg{};
+  std::array<T, K> m_t{};
+  // AM coefficients, rotated to line up with ring-buffer slots:
+  // m_ak_ring[p][s] multiplies slot s, when newest point is at slot p
+  std::array<std::array<Y, K>, K> m_ak_ring{};
+
+public:
+  //! Construct the solver. dt is the (constant) step size
+  //! @param dt -- (constant) step size
+  //! @param D -- Pointer to derivative matrix policy; must outlive solver
+  BatchODESolver2D(Y dt, const DM *D) : m_dt(dt), m_D(D) {
+    assert(dt != Y{0.0} && "Cannot have zero step-size in BatchODESolver2D");
+    assert(D != nullptr &&
+           "Cannot have null Derivative Matrix in BatchODESolver2D");
+    // ak[0] is for oldest point; oldest is at slot (p+1)%K if newest at p
+    for (std::size_t p = 0; p < K; ++p) {
+      for (std::size_t k = 0; k < K; ++k) {
+        m_ak_ring[p][(p + 1 + k) % K] = m_dt * static_cast<Y>(am.ak[k]);
+      }
+    }
+  }
+
+  //! Returns the AM order (number of steps), K
+  constexpr std::size_t K_steps() const { return K; }
+  //! Returns the number of lanes, N
+  constexpr std::size_t N_lanes() const { return N; }
+
+  //! Returns f (all lanes) for the kth most recent point (k=0 is newest)
+  const Lanes &f(std::size_t k = 0) const { return m_f[slot(k)]; }
+  //! Returns g (all lanes) for the kth most recent point (k=0 is newest)
+  const Lanes &g(std::size_t k = 0) const { return m_g[slot(k)]; }
+  //! Returns t for the kth most recent point (k=0 is newest)
+  T t(std::size_t k = 0) const { return m_t[slot(k)]; }
+  //! Returns most recent t value
+  T last_t() const { return m_t[m_newest]; }
+  //! Returns the step size
+  Y dt() const { return m_dt; }
+
+  //! Drives all lanes to next value, F(t_next), assuming the system has
+  //! already been solved for the K previous values. See ODESolver2D::drive().
+  void drive(T t_next) {
+    const auto &ak = m_ak_ring[m_newest];
+    Lanes sf = m_f[m_newest];
+    Lanes sg = m_g[m_newest];
+    for (std::size_t s = 0; s < K; ++s) {
+      const auto &dfs = m_df[s];
+      const auto &dgs = m_dg[s];
+      const auto as = ak[s];
+#pragma omp simd
+      for (std::size_t j = 0; j < N; ++j) {
+        sf[j] += as * dfs[j];
+        sg[j] += as * dgs[j];
+      }
+    }
+    m_newest = (m_newest + 1) % K;
+    solve_step(t_next, m_dt * static_cast<Y>(am.aK), sf, sg);
+  }
+
+  //! Drives to next point: t_next = last_t + dt (or last_t -/+ 1 for index t)
+  void drive() { drive(next_t(last_t())); }
+
+  //! Sets the first K values for F (and dF), given initial values F(t0) for
+  //! each lane, using successive N-step AM methods. See ODESolver2D.
+  void solve_initial_K(T t0, const Lanes &f0, const Lanes &g0) {
+    m_newest = 0;
+    set_point(t0, f0, g0);
+    first_k_i<1>(next_t(t0));
+  }
+
+  //! Directly sets a (new) point: shifts along, and sets newest F(t)=(f0,g0)
+  //! for all lanes (derivatives are calculated). Used to provide the first K
+  //! points (e.g., from an asymptotic expansion) in place of
+  //! solve_initial_K(). Call exactly K times before drive().
+  void push(T t0, const Lanes &f0, const Lanes &g0) {
+    m_newest = (m_newest + 1) % K;
+    set_point(t0, f0, g0);
+  }
+
+  //! Overwrites the newest point for a single lane j, i.e., F_j(last_t).
+  //! Allows lanes to be (re-)started from different points of the grid.
+  void set_lane(std::size_t j, Y f0, Y g0) {
+    const auto tt = m_t[m_newest];
+    m_f[m_newest][j] = f0;
+    m_g[m_newest][j] = g0;
+    m_df[m_newest][j] = m_D->a(tt, j) * f0 + m_D->b(tt, j) * g0;
+    m_dg[m_newest][j] = m_D->c(tt, j) * f0 + m_D->d(tt, j) * g0;
+  }
+
+private:
+  std::size_t slot(std::size_t k) const { return (m_newest + K - k) % K; }
+
+  void set_point(T t0, const Lanes &f0, const Lanes &g0) {
+    m_t[m_newest] = t0;
+    m_f[m_newest] = f0;
+    m_g[m_newest] = g0;
+    for (std::size_t j = 0; j < N; ++j) {
+      m_df[m_newest][j] = m_D->a(t0, j) * f0[j] + m_D->b(t0, j) * g0[j];
+      m_dg[m_newest][j] = m_D->c(t0, j) * f0[j] + m_D->d(t0, j) * g0[j];
+    }
+  }
+
+  // Solves the implicit AM equation for newest point (already at m_newest)
+  void solve_step(T t_next, Y a0, const Lanes &sf, const Lanes &sg) {
+    auto &fi = m_f[m_newest];
+    auto &gi = m_g[m_newest];
+    auto &dfi = m_df[m_newest];
+    auto &dgi = m_dg[m_newest];
+    m_t[m_newest] = t_next;
+    const auto a02 = a0 * a0;
+#pragma omp simd
+    for (std::size_t j = 0; j < N; ++j) {
+      const auto a = m_D->a(t_next, j);
+      const auto b = m_D->b(t_next, j);
+      const auto c = m_D->c(t_next, j);
+      const auto d = m_D->d(t_next, j);
+      const auto det_inv =
+          Y{1.0} / (Y{1.0} - (a02 * (b * c - a * d) + a0 * (a + d)));
+      fi[j] = (sf[j] - a0 * (d * sf[j] - b * sg[j])) * det_inv;
+      gi[j] = (sg[j] - a0 * (-c * sf[j] + a * sg[j])) * det_inv;
+      dfi[j] = a * fi[j] + b * gi[j];
+      dgi[j] = c * fi[j] + d * gi[j];
+    }
+  }
+
+  T next_t(T last) const {
+    if constexpr (std::is_integral_v<T> && is_complex_v<Y>) {
+      return (m_dt.real() > 0.0) ? last + 1 : last - 1;
+    } else if constexpr (std::is_integral_v<T>) {
+      return (m_dt > 0.0) ? last + 1 : last - 1;
+    } else {
+      return last + m_dt;
+    }
+  }
+
+  // Used recursively by solve_initial_K() to find first K points.
+  // At step ik, the ring buffer is not yet full, and slots 0..ik-1 hold the
+  // points in order (oldest first)
+  template <std::size_t ik>
+  void first_k_i(T t_next) {
+    if constexpr (ik >= K) {
+      (void)t_next;
+      return;
+    } else {
+      constexpr AM_Coefs<ik> ai{};
+      Lanes sf = m_f[ik - 1];
+      Lanes sg = m_g[ik - 1];
+      for (std::size_t s = 0; s < ik; ++s) {
+        const auto as = m_dt * static_cast<Y>(ai.ak[s]);
+        for (std::size_t j = 0; j < N; ++j) {
+          sf[j] += as * m_df[s][j];
+          sg[j] += as * m_dg[s][j];
+        }
+      }
+      m_newest = ik;
+      solve_step(t_next, m_dt * static_cast<Y>(ai.aK), sf, sg);
+      first_k_i<ik + 1>(next_t(t_next));
+    }
+  }
+};
+
 } // namespace AdamsMoulton
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "AdamsMoulton.hpp"
 #include "catch2/catch.hpp"
+#include <array>
 #include <cmath>
 
 //------------------------------------------------------------------------------
@@ -445,4 +446,67 @@ TEST_CASE("Inhomogenous with scale", "[AdamsMoulton][unit]") {
 
   REQUIRE(ode.last_t() ==
           Approx(t0 + (num_steps + (int)ode.K_steps() - 1) * ode.dt()));
-}
\ No newline at end of file
+}
+//------------------------------------------------------------------------------
+TEST_CASE("Batched: N independent lanes", "[AdamsMoulton][unit]") {
+
+  // y_j''(x) = -w_j^2 y_j(x)
+  // y_j(0)=0, y_j'(0)=w_j
+  // => y_j(x) = sin(w_j x)
+  struct Oscillators {
+    std::array<double, 4> w{1.0, 2.0, 3.0, 0.5};
+    double a(double, std::size_t) const { return 0.0; }
+    double b(double, std::size_t) const { return 1.0; }
+    double c(double, std::size_t j) const { return -w[j] * w[j]; }
+    double d(double, std::size_t) const { return 0.0; }
+  };
+  Oscillators D;
+
+  double dt = 0.001;
+  AdamsMoulton::BatchODESolver2D<5, 4, Oscillators, double> ode{dt, &D};
+  REQUIRE(ode.dt() == dt);
+  REQUIRE(ode.K_steps() == 5);
+  REQUIRE(ode.N_lanes() == 4);
+
+  double t0 = 0.0;
+  ode.solve_initial_K(t0, {0.0, 0.0, 0.0, 0.0}, D.w);
+
+  // test the initial points (k=0 is newest)
+  for (std::size_t k = 0; k < ode.K_steps(); ++k) {
+    const auto t = ode.t(k);
+    REQUIRE(t == Approx(t0 + double(ode.K_steps() - 1 - k) * dt));
+    for (std::size_t j = 0; j < ode.N_lanes(); ++j) {
+      REQUIRE(ode.f(k)[j] == Approx(std::sin(D.w[j] * t)).margin(1.0e-6));
+    }
+  }
+
+  // Compare to (un-batched) ODESolver2D for one of the lanes
+  struct DM : AdamsMoulton::DerivativeMatrix<double> {
+    double w2;
+    DM(double in_w2) : w2(in_w2) {}
+    double a(double) const final { return 0.0; }
+    double b(double) const final { return 1.0; }
+    double c(double) const final { return -w2; }
+    double d(double) const final { return 0.0; }
+  };
+  DM D2{D.w[2] * D.w[2]};
+  AdamsMoulton::ODESolver2D<5> ode2{dt, &D2};
+  ode2.solve_initial_K(t0, 0.0, D.w[2]);
+
+  int num_steps = 1000;
+  for (int i = 0; i < num_steps; ++i) {
+    ode.drive();
+    ode2.drive();
+    REQUIRE(ode.f()[2] == Approx(ode2.last_f()));
+    REQUIRE(ode.g()[2] == Approx(ode2.last_g()));
+  }
+  for (std::size_t j = 0; j < ode.N_lanes(); ++j) {
+    REQUIRE(ode.f()[j] ==
+            Approx(std::sin(D.w[j] * ode.last_t())).epsilon(1.0e-5));
+    REQUIRE(ode.g()[j] == Approx(D.w[j] * std::cos(D.w[j] * ode.last_t()))
+                              .epsilon(1.0e-5));
+  }
+
+  REQUIRE(ode.last_t() ==
+          Approx(t0 + (num_steps + (int)ode.K_steps() - 1) * ode.dt()));
+}
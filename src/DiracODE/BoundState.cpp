@@ -11,6 +11,7 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <numeric>
 #include <vector>
 
 namespace DiracODE {
@@ -143,6 +144,31 @@ Orbitals defined:
   return;
 }
 
+//==============================================================================
+void boundState(const std::vector<DiracSpinor *> &Fas,
+                const std::vector<double> &en0s, const std::vector<double> &v,
+                const std::vector<double> &H_mag, const double alpha,
+                double eps_goal, double zion, double mass) {
+  assert(Fas.size() == en0s.size() &&
+         "Must have one energy guess per orbital in boundState");
+
+  // Order states by (approximate) cost: number of nodes, and the number of
+  // points out to practical infinity, both of which grow with n.
+  // Solve most expensive states first, so dynamic scheduling balances well.
+  std::vector<std::size_t> order(Fas.size());
+  std::iota(order.begin(), order.end(), 0ul);
+  std::stable_sort(order.begin(), order.end(), [&](auto i, auto j) {
+    return Fas[i]->n() > Fas[j]->n();
+  });
+
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t ii = 0; ii < order.size(); ++ii) {
+    const auto i = order[ii];
+    boundState(*Fas[i], en0s[i], v, H_mag, alpha, eps_goal, nullptr, nullptr,
+               zion, mass);
+  }
+}
+
 //==============================================================================
 void regularAtOrigin(DiracSpinor &Fa, const double en,
                      const std::vector<double> &v,
@@ -185,6 +211,94 @@ void regularAtInfinity(DiracSpinor &Fa, const double en,
   Fa.zero_boundaries();
 }
 
+//==============================================================================
+// Splits list of orbitals into batches of N_batch, and calls solver(batch) for
+// each. Unused lanes (in final batch) are null.
+template <typename Function>
+static void for_each_batch(const std::vector<DiracSpinor *> &Fas,
+                           Function &&solver) {
+  constexpr auto N = Param::N_batch;
+  for (std::size_t i0 = 0; i0 < Fas.size(); i0 += N) {
+    std::array<DiracSpinor *, N> batch{};
+    for (std::size_t j = 0; j < N && i0 + j < Fas.size(); ++j) {
+      batch[j] = Fas[i0 + j];
+    }
+    solver(batch);
+  }
+}
+
+// Returns kappas and energies for each lane; null lanes are given the values
+// of the first lane (so the unused lanes remain numerically well-behaved)
+static std::pair<std::array<int, Param::N_batch>,
+                 std::array<double, Param::N_batch>>
+batch_kappa_en(const std::array<DiracSpinor *, Param::N_batch> &Fs) {
+  std::pair<std::array<int, Param::N_batch>, std::array<double, Param::N_batch>>
+      out;
+  auto &[kappas, ens] = out;
+  for (std::size_t j = 0; j < Param::N_batch; ++j) {
+    const auto *Fa = Fs[j] ? Fs[j] : Fs[0];
+    kappas[j] = Fa->kappa();
+    ens[j] = Fa->en();
+  }
+  return out;
+}
+
+//==============================================================================
+void regularAtOrigin(const std::vector<DiracSpinor *> &Fas,
+                     const std::vector<double> &v,
+                     const std::vector<double> &H_mag, const double alpha,
+                     double mass) {
+  if (Fas.empty())
+    return;
+  const auto &gr = Fas.front()->grid();
+  for_each_batch(Fas, [&](const auto &Fs) {
+    const auto [kappas, ens] = batch_kappa_en(Fs);
+    std::array<std::size_t, Param::N_batch> pinf{};
+    for (std::size_t j = 0; j < Param::N_batch; ++j) {
+      pinf[j] =
+          Internal::findPracticalInfinity(ens[j], v, gr.r(), Param::cALR);
+    }
+    const Internal::DiracDerivativeBatch<Param::N_batch> Hd(
+        gr, v, kappas, ens, alpha, H_mag, mass);
+    Internal::solve_Dirac_outwards(Fs, Hd, pinf);
+    for (std::size_t j = 0; j < Param::N_batch; ++j) {
+      if (Fs[j] == nullptr)
+        continue;
+      Fs[j]->min_pt() = 0;
+      Fs[j]->max_pt() = pinf[j];
+      Fs[j]->zero_boundaries();
+    }
+  });
+}
+
+//==============================================================================
+void regularAtInfinity(const std::vector<DiracSpinor *> &Fas,
+                       const std::vector<double> &v,
+                       const std::vector<double> &H_mag, const double alpha,
+                       double mass) {
+  if (Fas.empty())
+    return;
+  const auto &gr = Fas.front()->grid();
+  for_each_batch(Fas, [&](const auto &Fs) {
+    const auto [kappas, ens] = batch_kappa_en(Fs);
+    std::array<std::size_t, Param::N_batch> pinf{};
+    for (std::size_t j = 0; j < Param::N_batch; ++j) {
+      pinf[j] =
+          Internal::findPracticalInfinity(ens[j], v, gr.r(), Param::cALR);
+    }
+    const Internal::DiracDerivativeBatch<Param::N_batch> Hd(
+        gr, v, kappas, ens, alpha, H_mag, mass);
+    Internal::solve_Dirac_inwards(Fs, Hd, 0, pinf);
+    for (std::size_t j = 0; j < Param::N_batch; ++j) {
+      if (Fs[j] == nullptr)
+        continue;
+      Fs[j]->min_pt() = 0;
+      Fs[j]->max_pt() = pinf[j];
+      Fs[j]->zero_boundaries();
+    }
+  });
+}
+
 //==============================================================================
 //==============================================================================
 namespace Internal {
@@ -474,6 +588,171 @@ void solve_Dirac_inwards(std::vector<double> &f, std::vector<double> &g,
   }
 }
 
+//==============================================================================
+void solve_Dirac_outwards(
+    const std::array<DiracSpinor *, Param::N_batch> &Fs,
+    const DiracDerivativeBatch<Param::N_batch> &Hd,
+    const std::array<std::size_t, Param::N_batch> &pinf) {
+  constexpr auto N = Param::N_batch;
+
+  const auto &r = Hd.pgr->r();
+  const auto du = Hd.pgr->du();
+  const auto alpha = Hd.alpha;
+  const auto Z_eff = (-1.0 * Hd.v[0] * r[0]);
+  const double az0 = Z_eff < 1.0 ? alpha : Z_eff * alpha;
+
+  // Set initial values, using H-like form for f and ratio of f/g
+  std::array<double, N> f0{}, g0{};
+  for (std::size_t j = 0; j < N; ++j) {
+    const auto ka = Hd.k[j];
+    const double ga0 = std::sqrt(ka * ka - az0 * az0);
+    const auto g_f_ratio = (ka > 0) ? (ka + ga0) / az0 : az0 / (ka - ga0);
+    f0[j] = 2.0 * std::pow(r[0], ga0);
+    g0[j] = f0[j] * g_f_ratio;
+  }
+
+  const auto pinf_max = *std::max_element(pinf.begin(), pinf.end());
+
+  AdamsMoulton::BatchODESolver2D<Param::K_Adams, N,
+                                 DiracDerivativeBatch<N>, std::size_t, double>
+      ode{du, &Hd};
+
+  const auto store = [&](std::size_t i) {
+    const auto &fi = ode.f();
+    const auto &gi = ode.g();
+    for (std::size_t j = 0; j < N; ++j) {
+      if (Fs[j] != nullptr && i < pinf[j]) {
+        Fs[j]->f(i) = fi[j];
+        Fs[j]->g(i) = gi[j];
+      }
+    }
+  };
+
+  ode.solve_initial_K(0, f0, g0);
+  for (std::size_t k = 0; k < ode.K_steps(); ++k) {
+    const auto &fk = ode.f(ode.K_steps() - 1 - k);
+    const auto &gk = ode.g(ode.K_steps() - 1 - k);
+    for (std::size_t j = 0; j < N; ++j) {
+      if (Fs[j] != nullptr) {
+        Fs[j]->f(k) = fk[j];
+        Fs[j]->g(k) = gk[j];
+      }
+    }
+  }
+  for (std::size_t i = ode.K_steps(); i < pinf_max; ++i) {
+    ode.drive(i);
+    store(i);
+  }
+}
+
+//==============================================================================
+void solve_Dirac_inwards(const std::array<DiracSpinor *, Param::N_batch> &Fs,
+                         const DiracDerivativeBatch<Param::N_batch> &Hd,
+                         std::size_t nf,
+                         const std::array<std::size_t, Param::N_batch> &pinf) {
+  // Each lane starts from its own practical infinity. Lanes are kept at zero
+  // until reaching their own pinf; the first K points of each lane are then
+  // set from the asymptotic expansion, before being driven inwards.
+  constexpr auto N = Param::N_batch;
+  constexpr auto K = Param::K_Adams;
+
+  const auto &r = Hd.pgr->r();
+  const auto du = Hd.pgr->du();
+
+  std::vector<AsymptoticSpinor<>> Rasym;
+  Rasym.reserve(N);
+  for (std::size_t j = 0; j < N; ++j) {
+    const auto Zeff = -Hd.v[pinf[j] - 1] * r[pinf[j] - 1];
+    Rasym.emplace_back(int(Hd.k[j]), Zeff, Hd.en[j], Hd.alpha, Param::nx_eps,
+                       Hd.mass);
+  }
+
+  const auto pinf_max = *std::max_element(pinf.begin(), pinf.end());
+  assert(pinf_max >= K + nf);
+
+  AdamsMoulton::BatchODESolver2D<K, N, DiracDerivativeBatch<N>, std::size_t,
+                                 double>
+      ode{-du, &Hd};
+
+  // (Re)-starts lane j from asymptotic expansion, if i is one of its first K
+  // points. Returns true if lane was set
+  const auto asymptotic_point = [&](std::size_t i, std::size_t j, double *f0,
+                                    double *g0) {
+    if (i >= pinf[j] || i + K < pinf[j])
+      return false;
+    const auto [fa, ga] = Rasym[j].fg(r[i]);
+    *f0 = fa;
+    *g0 = ga;
+    return true;
+  };
+
+  const auto store = [&](std::size_t i) {
+    const auto &fi = ode.f();
+    const auto &gi = ode.g();
+    for (std::size_t j = 0; j < N; ++j) {
+      if (Fs[j] != nullptr) {
+        Fs[j]->f(i) = fi[j];
+        Fs[j]->g(i) = gi[j];
+      }
+    }
+  };
+
+  // First K points (from largest pinf):
+  for (std::size_t i = pinf_max - 1; i + K >= pinf_max; --i) {
+    std::array<double, N> f0{}, g0{};
+    for (std::size_t j = 0; j < N; ++j) {
+      asymptotic_point(i, j, &f0[j], &g0[j]);
+    }
+    ode.push(i, f0, g0);
+    store(i);
+  }
+
+  for (std::size_t i = pinf_max - K - 1; i >= nf; --i) {
+    ode.drive(i);
+    for (std::size_t j = 0; j < N; ++j) {
+      double f0, g0;
+      if (asymptotic_point(i, j, &f0, &g0))
+        ode.set_lane(j, f0, g0);
+    }
+    store(i);
+    if (i == 0)
+      break;
+  }
+
+  for (std::size_t j = 0; j < N; ++j) {
+    if (Fs[j] == nullptr)
+      continue;
+    for (std::size_t i = pinf[j]; i < Fs[j]->f().size(); ++i) {
+      Fs[j]->f(i) = 0.0;
+      Fs[j]->g(i) = 0.0;
+    }
+  }
+}
+
+//==============================================================================
+template <std::size_t N>
+DiracDerivativeBatch<N>::DiracDerivativeBatch(
+    const Grid &in_grid, const std::vector<double> &in_v,
+    const std::array<int, N> &in_k, const std::array<double, N> &in_en,
+    const double in_alpha, const std::vector<double> &V_off_diag,
+    double in_mass)
+    : pgr(&in_grid),
+      drdu(in_grid.drdu().data()),
+      drduor(in_grid.drduor().data()),
+      v(in_v.data()),
+      Hmag(V_off_diag.empty() ? nullptr : V_off_diag.data()),
+      k{},
+      en(in_en),
+      alpha(in_alpha),
+      cc(1.0 / in_alpha),
+      mass(in_mass) {
+  for (std::size_t j = 0; j < N; ++j) {
+    k[j] = double(in_k[j]);
+  }
+}
+
+template struct DiracDerivativeBatch<Param::N_batch>;
+
 //==============================================================================
 DiracDerivative::DiracDerivative(
     const Grid &in_grid, const std::vector<double> &in_v, const int in_k,
@@ -2,6 +2,7 @@
 #include "AdamsMoulton.hpp"
 #include "Physics/PhysConst_constants.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -27,6 +28,23 @@ void boundState(DiracSpinor &Fa, const double en0, const std::vector<double> &v,
                 const DiracSpinor *const Fa0 = nullptr, double zion = 1,
                 double mass = 1.0);
 
+//! @brief Solves bound-state problem for many orbitals at once, all with the
+//! same local potential, v (and H_off_diag).
+/*! @details
+Equivalent to calling boundState() for each orbital, with en0s[i] the initial
+energy guess for Fas[i] (must be same size as Fas). The states are solved in
+parallel (OpenMP); since the number of iterations required varies between
+states, they are dynamically scheduled, beginning with those expected to be
+most expensive (most nodes). The potential and off-diagonal arrays are shared
+between all states (never copied). Only the local problem is solved (no
+exchange).
+*/
+void boundState(const std::vector<DiracSpinor *> &Fas,
+                const std::vector<double> &en0s, const std::vector<double> &v,
+                const std::vector<double> &H_off_diag = {},
+                const double alpha = PhysConst::alpha, double eps = 1.0e-14,
+                double zion = 1, double mass = 1.0);
+
 inline DiracSpinor boundState(int n, int kappa, const double en0,
                               std::shared_ptr<const Grid> &gr,
                               const std::vector<double> &v,
@@ -58,6 +76,26 @@ void regularAtInfinity(DiracSpinor &Fa, const double en,
                        const DiracSpinor *const Fa0 = nullptr, double zion = 1,
                        double mass = 1.0);
 
+//! Batched version of regularAtOrigin(): solves for all orbitals in Fas at
+//! once, for common local potential v (and H_off_diag).
+/*! @details
+Each orbital is solved with its own kappa and energy, Fa.en(), which must
+already be set. Orbitals are integrated together in SIMD-friendly batches of
+Internal::Param::N_batch, which is substantially faster than solving each
+orbital separately. Only the homogeneous equation is solved (no exchange).
+*/
+void regularAtOrigin(const std::vector<DiracSpinor *> &Fas,
+                     const std::vector<double> &v,
+                     const std::vector<double> &H_off_diag,
+                     const double alpha, double mass = 1.0);
+
+//! Batched version of regularAtInfinity(): solves for all orbitals in Fas at
+//! once (each with own kappa and energy Fa.en()), for common local potential.
+void regularAtInfinity(const std::vector<DiracSpinor *> &Fas,
+                       const std::vector<double> &v,
+                       const std::vector<double> &H_off_diag,
+                       const double alpha, double mass = 1.0);
+
 namespace Internal {
 
 //==============================================================================
@@ -74,6 +112,8 @@ constexpr int max_its = 99;
 constexpr double lfrac_de = 0.12;
 // Num points past ctp +/- d_ctp.
 constexpr int d_ctp = 4;
+// Number of (SIMD) lanes used by the batched Dirac solvers
+constexpr std::size_t N_batch = 4;
 
 // order of the expansion coeficients in large-r asymptotic expansion  (15 orig.)
 constexpr int nx = 15;
@@ -123,6 +163,41 @@ struct DiracDerivative : AdamsMoulton::DerivativeMatrix<std::size_t, double> {
   void operator=(const DiracDerivative &) = delete;
 };
 
+//==============================================================================
+//! Dirac derivative matrix for N independent (kappa, energy) lanes on the same
+//! grid and potential. Non-virtual policy for AdamsMoulton::BatchODESolver2D.
+template <std::size_t N>
+struct DiracDerivativeBatch {
+
+  DiracDerivativeBatch(const Grid &in_grid, const std::vector<double> &in_v,
+                       const std::array<int, N> &in_k,
+                       const std::array<double, N> &in_en,
+                       const double in_alpha,
+                       const std::vector<double> &V_off_diag = {},
+                       double in_mass = 1.0);
+
+  const Grid *const pgr;
+  const double *const drdu;
+  const double *const drduor;
+  const double *const v;
+  const double *const Hmag;
+  std::array<double, N> k;
+  std::array<double, N> en;
+  const double alpha, cc, mass;
+
+  double a(std::size_t i, std::size_t j) const {
+    const auto h_mag = (Hmag == nullptr) ? 0.0 : Hmag[i];
+    return -k[j] * drduor[i] + alpha * h_mag * drdu[i];
+  }
+  double b(std::size_t i, std::size_t j) const {
+    return (alpha * en[j] + 2.0 * mass * cc - alpha * v[i]) * drdu[i];
+  }
+  double c(std::size_t i, std::size_t j) const {
+    return alpha * (v[i] - en[j]) * drdu[i];
+  }
+  double d(std::size_t i, std::size_t j) const { return -a(i, j); }
+};
+
 //==============================================================================
 // To keep track of current/previous energy guesses
 struct TrackEnGuess {
@@ -188,6 +263,20 @@ void solve_Dirac_inwards(std::vector<double> &f, std::vector<double> &g,
                          const DiracDerivative &Hd, std::size_t ctp,
                          std::size_t pinf, double mass = 1.0);
 
+// Batched solve_Dirac_outwards: solves for each lane j (Fs[j] may be null, in
+// which case that lane is ignored), integrating to pinf[j] (not inclusive).
+void solve_Dirac_outwards(
+    const std::array<DiracSpinor *, Param::N_batch> &Fs,
+    const DiracDerivativeBatch<Param::N_batch> &Hd,
+    const std::array<std::size_t, Param::N_batch> &pinf);
+
+// Batched solve_Dirac_inwards: each lane j integrated inwards from its own
+// pinf[j] to nf. Lanes with null Fs[j] are ignored.
+void solve_Dirac_inwards(const std::array<DiracSpinor *, Param::N_batch> &Fs,
+                         const DiracDerivativeBatch<Param::N_batch> &Hd,
+                         std::size_t nf,
+                         const std::array<std::size_t, Param::N_batch> &pinf);
+
 // Meshes the two solutions from inwards/outwards integration.
 // Produces solution that has correct boundary conditions at 0 and infinity,
 // but may not be smooth at the joining point.
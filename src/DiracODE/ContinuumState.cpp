@@ -5,24 +5,21 @@
 #include "Wavefunction/DiracSpinor.hpp"
 #include "fmt/color.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 namespace DiracODE {
 using namespace DiracODE::Internal;
 
 //==============================================================================
-void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
-                    double alpha, const DiracSpinor *const VxFa,
-                    const DiracSpinor *const Fa0) {
-
-  Fa.en() = en;
+// Checks that the radial grid is dense enough at large r for continuum state
+// of energy en. If not, prints error, writes zeros to Fa, and returns false.
+static bool check_continuum_grid(DiracSpinor &Fa, double en) {
   const auto &gr = Fa.grid();
-  const auto num_points = gr.num_points();
-  Fa.max_pt() = num_points;
 
   // Rough expression for wavelenth at large r
   // nb: sin(kr + \eta * log(kr)), so not exactly constant
-  const double approx_wavelength = 2.0 * M_PI / std::sqrt(2.0 * Fa.en());
+  const double approx_wavelength = 2.0 * M_PI / std::sqrt(2.0 * en);
 
   // The solution on the radial grid must be reasonable at large r
   // We ensure there is at least N (N=10) points per wavelength in this region
@@ -38,13 +35,14 @@ void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
         "Writing zeros to Spinor for this state.\n",
         en, Fa.kappa(), dr0_target);
     Fa *= 0.0;
-    return;
+    return false;
   }
+  return true;
+}
 
-  // Solve on regular grid - not yet normalised:
-  DiracDerivative Hd(Fa.grid(), v, Fa.kappa(), Fa.en(), alpha, {}, VxFa, Fa0);
-  solve_Dirac_outwards(Fa.f(), Fa.g(), Hd);
-
+// Normalises continuum solution Fa (already solved on regular grid)
+static void normalise_continuum(DiracSpinor &Fa, double en,
+                                const std::vector<double> &v, double alpha) {
   // Now, normalise the solution.
   // Keep solving ODE outwards, on linearly-spaced grid
   // Use "H-like" derivative: assume exchange etc. negligable here
@@ -54,6 +52,10 @@ void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
   // Until they stabilise; find amplitude in this region
   // Re-scale wavefunction so tha large-r amplitude matches analytic expression
 
+  const auto &gr = Fa.grid();
+  const double approx_wavelength = 2.0 * M_PI / std::sqrt(2.0 * en);
+  const auto dr0 = gr.drdu().back() * gr.du();
+
   // Step-size for large-r solution: Uses linear grid
   // Require at least 40 points per wavelength (20 per half-wave)
   // but limit to ~100 pts per half-wave (? no benefit after this)
@@ -71,7 +73,7 @@ void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
   const auto [amp, eps_amp] = numerical_f_amplitude(
       en, Fa.kappa(), alpha, Zeff, f_final, g_final, r_final, dr);
 
-  Fa.max_pt() = num_points;
+  Fa.max_pt() = gr.num_points();
   Fa.eps() = eps_amp;
 
   // Calculate normalisation coeficient, D, and re-scaling factor:
@@ -79,6 +81,61 @@ void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
   Fa *= (D / amp);
 }
 
+//==============================================================================
+void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
+                    double alpha, const DiracSpinor *const VxFa,
+                    const DiracSpinor *const Fa0) {
+
+  Fa.en() = en;
+  Fa.max_pt() = Fa.grid().num_points();
+
+  if (!check_continuum_grid(Fa, en))
+    return;
+
+  // Solve on regular grid - not yet normalised:
+  DiracDerivative Hd(Fa.grid(), v, Fa.kappa(), Fa.en(), alpha, {}, VxFa, Fa0);
+  solve_Dirac_outwards(Fa.f(), Fa.g(), Hd);
+
+  normalise_continuum(Fa, en, v, alpha);
+}
+
+//==============================================================================
+void solveContinuum(const std::vector<DiracSpinor *> &Fas, double en,
+                    const std::vector<double> &v, double alpha) {
+
+  // Only solve for those states for which grid is dense enough:
+  std::vector<DiracSpinor *> to_solve;
+  to_solve.reserve(Fas.size());
+  for (auto *Fa : Fas) {
+    Fa->en() = en;
+    Fa->max_pt() = Fa->grid().num_points();
+    if (check_continuum_grid(*Fa, en))
+      to_solve.push_back(Fa);
+  }
+
+  // Solve on regular grid (all kappas together) - not yet normalised:
+  for (std::size_t i0 = 0; i0 < to_solve.size(); i0 += Param::N_batch) {
+    std::array<DiracSpinor *, Param::N_batch> Fs{};
+    std::array<int, Param::N_batch> kappas{};
+    std::array<double, Param::N_batch> ens{};
+    std::array<std::size_t, Param::N_batch> pinf{};
+    for (std::size_t j = 0; j < Param::N_batch; ++j) {
+      const auto i = std::min(i0 + j, to_solve.size() - 1);
+      Fs[j] = (i0 + j < to_solve.size()) ? to_solve[i] : nullptr;
+      kappas[j] = to_solve[i]->kappa();
+      ens[j] = en;
+      pinf[j] = to_solve[i]->grid().num_points();
+    }
+    const DiracDerivativeBatch<Param::N_batch> Hd(to_solve[i0]->grid(), v,
+                                                  kappas, ens, alpha);
+    solve_Dirac_outwards(Fs, Hd, pinf);
+  }
+
+  for (auto *Fa : to_solve) {
+    normalise_continuum(*Fa, en, v, alpha);
+  }
+}
+
 //==============================================================================
 std::pair<double, double> numerical_f_amplitude(double en, int kappa,
                                                 double alpha, double Zeff,
@@ -18,6 +18,12 @@ void solveContinuum(DiracSpinor &Fa, double en, const std::vector<double> &v,
                     double alpha, const DiracSpinor *const VxFa = nullptr,
                     const DiracSpinor *const Fa0 = nullptr);
 
+//! Batched version of solveContinuum(): solves for all orbitals in Fas (each
+//! with own kappa) at energy en, for common local potential v (no exchange).
+//! Orbitals are integrated together in SIMD-friendly batches.
+void solveContinuum(const std::vector<DiracSpinor *> &Fas, double en,
+                    const std::vector<double> &v, double alpha);
+
 //! Analytic amplitude of f(r) at very large r, for H-like Dirac continuum
 double analytic_f_amplitude(double en, double alpha);
 
@@ -195,6 +195,127 @@ TEST_CASE("DiracODE: Adams-Moulton method", "[DiracODE][unit]") {
   }
 }
 
+//==============================================================================
+//! Batched solvers should give same solutions as un-batched ones
+TEST_CASE("DiracODE: batched solvers", "[DiracODE][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "DiracODE: batched solvers\n";
+
+  const auto Zeff{10.0};
+  const auto grid = std::make_shared<const Grid>(
+      5.0e-7 / Zeff, 500.0 / Zeff, 2000ul, GridType::loglinear, 10.0);
+  const auto v_nuc = Nuclear::sphericalNuclearPotential(Zeff, 0.0, grid->r());
+
+  // Use more than Param::N_batch states, so batches are partially filled
+  const auto states_list = AtomData::listOfStates_nk("4spd");
+  REQUIRE(states_list.size() > DiracODE::Internal::Param::N_batch);
+
+  std::vector<DiracSpinor> Fs0, Fsi, Fb0, Fbi;
+  for (const auto &[n, k, en] : states_list) {
+    const auto en_guess = -(Zeff * Zeff) / (2.0 * n * n);
+    for (auto *Fs : {&Fs0, &Fsi, &Fb0, &Fbi}) {
+      auto &Fa = Fs->emplace_back(n, k, grid);
+      Fa.en() = en_guess;
+    }
+  }
+
+  std::vector<DiracSpinor *> pFb0, pFbi;
+  for (std::size_t i = 0; i < Fs0.size(); ++i) {
+    DiracODE::regularAtOrigin(Fs0[i], Fs0[i].en(), v_nuc, {}, PhysConst::alpha);
+    DiracODE::regularAtInfinity(Fsi[i], Fsi[i].en(), v_nuc, {},
+                                PhysConst::alpha);
+    pFb0.push_back(&Fb0[i]);
+    pFbi.push_back(&Fbi[i]);
+  }
+  DiracODE::regularAtOrigin(pFb0, v_nuc, {}, PhysConst::alpha);
+  DiracODE::regularAtInfinity(pFbi, v_nuc, {}, PhysConst::alpha);
+
+  double worst0 = 0.0, worsti = 0.0;
+  for (std::size_t i = 0; i < Fs0.size(); ++i) {
+    REQUIRE(Fb0[i].min_pt() == Fs0[i].min_pt());
+    REQUIRE(Fb0[i].max_pt() == Fs0[i].max_pt());
+    REQUIRE(Fbi[i].min_pt() == Fsi[i].min_pt());
+    REQUIRE(Fbi[i].max_pt() == Fsi[i].max_pt());
+    const auto n0 = std::sqrt(Fs0[i] * Fs0[i]);
+    const auto ni = std::sqrt(Fsi[i] * Fsi[i]);
+    const auto d0 = Fb0[i] - Fs0[i];
+    const auto di = Fbi[i] - Fsi[i];
+    worst0 = std::max(worst0, std::sqrt(d0 * d0) / n0);
+    worsti = std::max(worsti, std::sqrt(di * di) / ni);
+  }
+  std::cout << "regularAtOrigin: " << worst0 << "\n";
+  std::cout << "regularAtInfinity: " << worsti << "\n";
+  CHECK(worst0 < 1.0e-10);
+  CHECK(worsti < 1.0e-10);
+
+  // Continuum (all kappas at same energy)
+  std::vector<DiracSpinor> Fc, Fcb;
+  std::vector<DiracSpinor *> pFcb;
+  for (const auto kappa : {-1, 1, -2, 2, -3, 3}) {
+    Fc.emplace_back(0, kappa, grid);
+    Fcb.emplace_back(0, kappa, grid);
+  }
+  for (auto &Fa : Fcb) {
+    pFcb.push_back(&Fa);
+  }
+  const auto ec = 0.5;
+  for (auto &Fa : Fc) {
+    DiracODE::solveContinuum(Fa, ec, v_nuc, PhysConst::alpha);
+  }
+  DiracODE::solveContinuum(pFcb, ec, v_nuc, PhysConst::alpha);
+  // nb: normalisation is only found to ~1.0e-5 (see Fa.eps()), and is
+  // sensitive to round-off differences, so don't expect exact agreement
+  double worstc = 0.0;
+  for (std::size_t i = 0; i < Fc.size(); ++i) {
+    const auto dc = Fcb[i] - Fc[i];
+    worstc = std::max(worstc, std::sqrt((dc * dc) / (Fc[i] * Fc[i])));
+  }
+  std::cout << "solveContinuum: " << worstc << "\n";
+  CHECK(worstc < 1.0e-3);
+}
+
+//==============================================================================
+TEST_CASE("DiracODE: batched boundState", "[DiracODE][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "DiracODE: batched boundState\n";
+
+  const auto Zeff{5.0};
+  const auto grid = std::make_shared<const Grid>(
+      5.0e-7 / Zeff, 500.0 / Zeff, 2000ul, GridType::loglinear, 10.0);
+  const auto v_nuc = Nuclear::sphericalNuclearPotential(Zeff, 0.0, grid->r());
+
+  std::vector<DiracSpinor> orbs_single, orbs_batch;
+  std::vector<DiracSpinor *> Fas;
+  std::vector<double> en0s;
+  for (const auto &[n, k, en] : AtomData::listOfStates_nk("6spdf")) {
+    const auto en_guess = -(Zeff * Zeff) / (2.0 * n * n);
+    DiracODE::boundState(orbs_single.emplace_back(n, k, grid), en_guess, v_nuc,
+                         {}, PhysConst::alpha, 1.0e-15);
+    orbs_batch.emplace_back(n, k, grid);
+    en0s.push_back(en_guess);
+  }
+  for (auto &Fa : orbs_batch) {
+    Fas.push_back(&Fa);
+  }
+  DiracODE::boundState(Fas, en0s, v_nuc, {}, PhysConst::alpha, 1.0e-15);
+
+  double worst_en = 0.0, worst_F = 0.0;
+  for (std::size_t i = 0; i < orbs_single.size(); ++i) {
+    const auto &Fa = orbs_single[i];
+    const auto &Fb = orbs_batch[i];
+    const auto exact =
+        AtomData::diracen(Zeff, Fb.n(), Fb.kappa(), PhysConst::alpha);
+    REQUIRE(Fb.max_pt() == Fa.max_pt());
+    REQUIRE(Fb.its() == Fa.its());
+    worst_en = std::max(worst_en, std::abs((Fb.en() - exact) / exact));
+    worst_F = std::max(worst_F, std::abs((Fb - Fa) * (Fb - Fa)));
+  }
+  std::cout << "en vs. exact (eps): " << worst_en << "\n";
+  std::cout << "batch vs. single: " << worst_F << "\n";
+  CHECK(worst_en < 1.0e-9);
+  CHECK(worst_F < 1.0e-20);
+}
+
 //==============================================================================
 // Test inhomogenous (Green's) method:
 TEST_CASE("DiracODE: inhomogenous (Green's) method", "[DiracODE][unit]") {
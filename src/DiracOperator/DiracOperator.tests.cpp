@@ -386,12 +386,16 @@ TEST_CASE("DiracOperator", "[DiracOperator][unit]") {
     auto g0jl = DiracOperator::g0jL(wf.grid(), qgrid, in_max_l);
     auto ig5jL = DiracOperator::ig5jL(wf.grid(), qgrid, in_max_l);
     // auto ig0g5jL = DiracOperator::ig0g5jL(wf.grid(), qgrid, in_max_l);
-    // constructing from existing operator: copies table
-    // (should only see "Filling jL lookup table:" 3 times)
+    // constructing from existing operator: shares table
     auto ig0g5jL = DiracOperator::ig0g5jL(jl);
 
     REQUIRE(&jl.q_grid() == &qgrid);
     REQUIRE(&jl.r_grid() == &wf.grid());
+    REQUIRE(jl.max_pt() == wf.grid().num_points());
+    // Table is shared between all (same grids): only filled once
+    REQUIRE(&jl.table() == &g0jl.table());
+    REQUIRE(&jl.table() == &ig5jL.table());
+    REQUIRE(&jl.table() == &ig0g5jL.table());
 
     // We never call set_L_q on these ones!
     const DiracOperator::jL jl_0 = jl;
@@ -515,6 +519,55 @@ TEST_CASE("DiracOperator", "[DiracOperator][unit]") {
         }
       }
     }
+
+    // Table truncated to extent of 'bound' orbitals: same MEs, so long as
+    // one orbital is bound
+    auto bound = wf.valence();
+    for (auto &Fb : bound) {
+      Fb.max_pt() = wf.grid().getIndex(60.0);
+      Fb.zero_boundaries();
+    }
+    const auto max_pt = bound.front().max_pt();
+    REQUIRE(max_pt < wf.grid().num_points());
+    auto jl_t = DiracOperator::jL(wf.grid(), qgrid, in_max_l, false, max_pt);
+    REQUIRE(jl_t.max_pt() == max_pt);
+    REQUIRE(&jl_t.table() != &jl.table());
+    for (auto l = 0ul; l <= jl.max_L(); ++l) {
+      for (const auto q : {qgrid.r(2), qgrid.r(7)}) {
+        jl_t.set_L_q(l, q);
+        jl.set_L_q(l, q);
+        for (const auto &a : wf.valence()) {
+          for (const auto &b : bound) {
+            if (jl.isZero(a, b))
+              continue;
+            REQUIRE(jl_t.reducedME(a, b) == Approx(jl.reducedME(a, b)));
+            REQUIRE(jl_t.rme(a, b, l, q) == Approx(jl_0.rme(a, b, l, q)));
+          }
+        }
+      }
+    }
+
+    // Batched over q (rme_q) vs. rme, including 'subtract one' versions
+    const DiracOperator::jL jl_m1(wf.grid(), qgrid, in_max_l, true);
+    const DiracOperator::g0jL g0jl_m1 = jl_m1;
+    for (const auto *h : std::vector<const DiracOperator::jL *>{
+             &jl_0, &g0jl_0, &ig5jL_0, &ig0g5jL_0, &jl_m1, &g0jl_m1, &jl_t}) {
+      for (auto l = 0ul; l <= h->max_L(); ++l) {
+        for (const auto &b : h == &jl_t ? bound : wf.valence()) {
+          const auto me = h->rme_q(wf.valence(), b, l);
+          REQUIRE(me.rows() == qgrid.num_points());
+          REQUIRE(me.cols() == wf.valence().size());
+          for (std::size_t iq = 0; iq < qgrid.num_points(); ++iq) {
+            for (std::size_t ia = 0; ia < wf.valence().size(); ++ia) {
+              const auto &a = wf.valence()[ia];
+              const auto me0 =
+                  h->is_zero(a, b, l) ? 0.0 : h->rme(a, b, l, qgrid.r(iq));
+              REQUIRE(me(iq, ia) == Approx(me0).margin(1.0e-12));
+            }
+          }
+        }
+      }
+    }
   }
 
   //--------------------------------------------------------------------
@@ -556,6 +609,42 @@ TEST_CASE("DiracOperator", "[DiracOperator][unit]") {
       REQUIRE(lhs == Approx(rhs));
     }
   }
+
+  //--------------------------------------------------------------------
+  SECTION("Truncated support") {
+    std::cout << "Truncated support\n";
+    // Radial integrals only run over overlapping [min_pt, max_pt); compare to
+    // same spinors with support extending over full grid
+    const auto num_points = wf.grid().num_points();
+    auto orbs_trunc = orbs;
+    for (auto &Fn : orbs_trunc) {
+      Fn.min_pt() = 40 + 10 * std::size_t(Fn.l());
+      Fn.max_pt() = num_points - 200 - 50 * std::size_t(Fn.n());
+      Fn.zero_boundaries();
+    }
+    auto orbs_full = orbs_trunc;
+    for (auto &Fn : orbs_full) {
+      Fn.min_pt() = 0;
+      Fn.max_pt() = num_points;
+    }
+
+    for (const auto &oper : {"E1", "E2", "r"}) {
+      const auto h = DiracOperator::generate(oper, {}, wf);
+      for (std::size_t a = 0; a < orbs.size(); ++a) {
+        for (std::size_t b = 0; b < orbs.size(); ++b) {
+          const auto &Fa = orbs_trunc[a];
+          const auto &Fb = orbs_trunc[b];
+          if (h->isZero(Fa, Fb))
+            continue;
+          const auto Rab = h->radialIntegral(Fa, Fb);
+          const auto Rab0 = h->radialIntegral(orbs_full[a], orbs_full[b]);
+          const auto Rab_x = h->radialIntegral_x(Fa, Fb);
+          REQUIRE(Rab == Approx(Rab0).epsilon(1.0e-13).margin(1.0e-15));
+          REQUIRE(Rab_x == Approx(Rab0).epsilon(1.0e-13).margin(1.0e-15));
+        }
+      }
+    }
+  }
 }
 
 //--------------------------------------------------------------------
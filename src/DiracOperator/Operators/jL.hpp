@@ -1,8 +1,16 @@
 #pragma once
 #include "DiracOperator/TensorOperator.hpp"
+#include "LinAlg/Matrix.hpp"
 #include "Maths/Grid.hpp"
+#include "Maths/NumCalc_quadIntegrate.hpp"
 #include "Maths/SphericalBessel.hpp"
 #include "Wavefunction/Wavefunction.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
 
 namespace DiracOperator {
 
@@ -18,18 +26,24 @@ Must use set_L_q (which sets L and q value) prior to use. Note: this is not thre
 */
 class jL : public TensorOperator {
 public:
-  //! Contruction takes radial grid, a q grid, and a maximum L. Fills lookup table
+  //! Contruction takes radial grid, a q grid, and a maximum L. Fills lookup
+  //! table (or re-uses existing one).
+  /*! @details If max_pt is given (non-zero), table is only stored for r <
+  r(max_pt), and jL is taken to be zero beyond this. Then, matrix elements
+  are only correct if (at least) one of the orbitals is zero beyond max_pt
+  (e.g., max_pt = largest max_pt() of core/basis orbitals; continuum states
+  may extend further). The table is shared between all jL operators (of any
+  type) with the same grids, max_l, and max_pt.
+  */
   jL(const Grid &r_grid, const Grid &q_grid, std::size_t max_l,
-     bool subtract_one = false)
+     bool subtract_one = false, std::size_t max_pt = 0)
       : TensorOperator(-1, Parity::blank),
         m_max_l(max_l),
-        m_j_lq_r(m_max_l + 1, q_grid.num_points()),
+        m_j_lq_r(get_table(r_grid, q_grid, max_l, max_pt)),
         m_r_grid(&r_grid),
         m_q_grid(&q_grid),
-        m_subtract_one(subtract_one) {
-    fill_table();
-  }
-  //! Constructing from existing operator: copies JL table - faster. Can copy from a jL of different type (g0,g5 etc)
+        m_subtract_one(subtract_one) {}
+  //! Constructing from existing operator: shares JL table - faster. Can copy from a jL of different type (g0,g5 etc)
   jL(const jL &other)
       : TensorOperator(-1, Parity::blank),
         m_max_l(other.m_max_l),
@@ -42,24 +56,75 @@ public:
   jL &operator=(const jL &) = delete;
 
 protected:
+  // j_L(qr) table: for each L, matrix {q, r} (i.e., each row is a new q).
+  // Read-only; shared between operators
+  using Table = std::vector<LinAlg::Matrix<double>>;
   std::size_t m_max_l;
-  LinAlg::Matrix<std::vector<double>> m_j_lq_r;
+  std::shared_ptr<const Table> m_j_lq_r;
   const Grid *m_r_grid;
   const Grid *m_q_grid;
   bool m_subtract_one;
 
 private:
-  // fills lookup J_l_q_r table
-  void fill_table() {
+  // Returns existing table (if one exists for these grids), or fills new one.
+  // Only weak pointers are kept, so table is freed with last operator using it
+  static std::shared_ptr<const Table> get_table(const Grid &r_grid,
+                                                const Grid &q_grid,
+                                                std::size_t max_l,
+                                                std::size_t max_pt) {
+    if (max_pt == 0 || max_pt > r_grid.num_points())
+      max_pt = r_grid.num_points();
+    using Key = std::tuple<double, double, std::size_t, double, double, double,
+                           std::size_t, std::size_t, std::size_t>;
+    static std::map<Key, std::weak_ptr<const Table>> s_tables;
+    static std::mutex s_mutex;
+
+    const Key key{r_grid.r0(), r_grid.rmax(),       r_grid.num_points(),
+                  r_grid.du(), q_grid.r0(),         q_grid.rmax(),
+                  max_l,       q_grid.num_points(), max_pt};
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto &weak_table = s_tables[key];
+    if (auto table = weak_table.lock()) {
+      std::cout << "Re-using jL lookup table\n";
+      return table;
+    }
+    auto table = fill_table(r_grid, q_grid, max_l, max_pt);
+    weak_table = table;
+    return table;
+  }
+
+  // fills lookup J_l_q_r table, for r < r(max_pt)
+  static std::shared_ptr<const Table> fill_table(const Grid &r_grid,
+                                                 const Grid &q_grid,
+                                                 std::size_t max_l,
+                                                 std::size_t max_pt) {
     std::cout << "Filling jL lookup table: " << std::flush;
-    for (std::size_t l = 0; l <= m_max_l; ++l) {
+    auto table = std::make_shared<Table>(
+        max_l + 1, LinAlg::Matrix<double>(q_grid.num_points(), max_pt));
+    // All L at once for each q (recurrence)
 #pragma omp parallel for
-      for (std::size_t iq = 0; iq < m_q_grid->num_points(); ++iq) {
-        m_j_lq_r.at(l, iq) = SphericalBessel::fillBesselVec_kr(
-            int(l), m_q_grid->r(iq), m_r_grid->r());
+    for (std::size_t iq = 0; iq < q_grid.num_points(); ++iq) {
+      const auto jlq = SphericalBessel::fillBesselVecs_kr(
+          int(max_l), q_grid.r(iq), r_grid.r(), max_pt);
+      for (std::size_t l = 0; l <= max_l; ++l) {
+        std::copy(jlq[l].cbegin(), jlq[l].cend(), (*table)[l][iq]);
       }
     }
-    std::cout << "done.\n";
+    std::cout << "done. ("
+              << double((max_l + 1) * q_grid.num_points() * max_pt *
+                        sizeof(double)) /
+                     1.0e6
+              << " MB)\n";
+    return table;
+  }
+
+protected:
+  // Sets m_vec to j_L(qr) (from the table); zero beyond max_pt
+  void set_vec(std::size_t L, double q) {
+    const auto iq = m_q_grid->getIndex(q);
+    const auto *const jlq = m_j_lq_r->at(L)[iq];
+    m_vec.assign(m_r_grid->num_points(), 0.0);
+    std::copy(jlq, jlq + max_pt(), m_vec.begin());
   }
 
 public:
@@ -67,6 +132,10 @@ public:
   std::size_t L() const { return std::size_t(m_rank); }
   //! Maximum L value in table.
   std::size_t max_L() const { return m_max_l; }
+  //! Table is stored (and jL taken non-zero) for r < r(max_pt)
+  std::size_t max_pt() const { return m_j_lq_r->front().cols(); }
+  //! Underlying table: for each L, matrix {q, r}. Shared between operators
+  const Table &table() const { return *m_j_lq_r; }
 
   const auto &q_grid() const { return *m_q_grid; }
   const auto &r_grid() const { return *m_r_grid; }
@@ -76,8 +145,7 @@ public:
     assert(L <= m_max_l && "L must be <= max L");
     m_rank = int(L);
     m_parity = Angular::evenQ(m_rank) ? Parity::even : Parity::odd;
-    const auto iq = m_q_grid->getIndex(q);
-    m_vec = m_j_lq_r.at(L, iq);
+    set_vec(L, q);
   }
 
   // This is _not_ thread safe
@@ -148,17 +216,17 @@ public:
   double rme(const DiracSpinor &a, const DiracSpinor &b, std::size_t L,
              double q) const {
     const auto iq = m_q_grid->getIndex(q);
-    const auto &jlqr = m_j_lq_r.at(L, iq);
+    const auto *const jlqr = m_j_lq_r->at(L)[iq];
     const auto &gr = *m_r_grid;
     const auto cff = angularCff(a.kappa(), b.kappa());
     const auto cgg = angularCgg(a.kappa(), b.kappa());
     const auto cfg = angularCfg(a.kappa(), b.kappa());
     const auto cgf = angularCgf(a.kappa(), b.kappa());
-    auto max = std::min(a.max_pt(), b.max_pt());
+    auto max = std::min({a.max_pt(), b.max_pt(), max_pt()});
 
     double Rf{0.0}, Rg{0.0};
     if (m_subtract_one && a.kappa() == b.kappa() && L == 0) {
-      auto jl_neg1 = jlqr;
+      std::vector<double> jl_neg1(jlqr, jlqr + max);
       for (auto &el : jl_neg1) {
         el -= 1.0;
       }
@@ -179,7 +247,7 @@ public:
         Rg = NumCalc::integrate(1.0, 0, max, a.g(), b.g(), jl_neg1, gr.drdu());
       } else if (cgg < -0.01) {
         //scalar (-ve sign is inside cgg)
-        auto jl_p1 = jlqr;
+        std::vector<double> jl_p1(jlqr, jlqr + max);
         for (auto &el : jl_p1) {
           el += 1.0;
         }
@@ -208,6 +276,74 @@ public:
            (cff * Rf + cgg * Rg + cfg * Rfg + cgf * Rgf) * gr.du();
   }
 
+  //! Reduced matrix elements <a||jL(q)||b>, for each a in Fas, for every q in
+  //! q_grid, for given L. Returned as matrix {iq, ia}. This *is* thread safe
+  /*! @details Same as calling rme(a, b, L, q) for each a and q, but faster:
+  the (angular and quadrature weighted) overlap densities for each a are formed
+  once, and then all q are done as a single matrix product (BLAS dgemm) with
+  the jL table, restricted to the radial range required. Zero for a where
+  is_zero(a, b, L).
+  */
+  LinAlg::Matrix<double> rme_q(const std::vector<DiracSpinor> &Fas,
+                               const DiracSpinor &b, std::size_t L) const {
+    const auto &gr = *m_r_grid;
+    const auto &drdu = gr.drdu();
+    const auto num_q = m_q_grid->num_points();
+
+    // Only non-zero MEs, and only out to furthest radial point required
+    std::vector<std::size_t> index;
+    std::size_t r_max = 0;
+    for (std::size_t ia = 0; ia < Fas.size(); ++ia) {
+      if (is_zero(Fas[ia], b, L))
+        continue;
+      index.push_back(ia);
+      r_max = std::max(r_max,
+                       std::min({Fas[ia].max_pt(), b.max_pt(), max_pt()}));
+    }
+    LinAlg::Matrix<double> me(num_q, Fas.size());
+    if (index.empty())
+      return me;
+
+    // rho(r, a): one column for each a
+    LinAlg::Matrix<double> rho(r_max, index.size());
+    // For subtract_one: <a|(jL-1)|b> = <a|jL|b> - <a|b> (vector and scalar)
+    std::vector<double> overlap(index.size(), 0.0);
+    for (std::size_t k = 0; k < index.size(); ++k) {
+      const auto &a = Fas[index[k]];
+      const auto cff = angularCff(a.kappa(), b.kappa());
+      const auto cgg = angularCgg(a.kappa(), b.kappa());
+      const auto cfg = angularCfg(a.kappa(), b.kappa());
+      const auto cgf = angularCgf(a.kappa(), b.kappa());
+      const auto kb = cfg == 0.0 ? b.kappa() : -b.kappa();
+      const auto s = cfg == 0.0 ? 1.0 : -1.0;
+      const auto c = s * Angular::Ck_kk(int(L), a.kappa(), kb) * gr.du();
+      const auto max = std::min({a.max_pt(), b.max_pt(), max_pt()});
+      const auto w = NumCalc::integrate_weights(max, gr.num_points());
+      const bool subtract_one =
+          m_subtract_one && a.kappa() == b.kappa() && L == 0;
+      for (std::size_t i = 0; i < w.size(); ++i) {
+        const auto cw = c * w[i] * drdu[i];
+        rho(i, k) = cw * (cff * a.f(i) * b.f(i) + cgg * a.g(i) * b.g(i) +
+                          cfg * a.f(i) * b.g(i) + cgf * a.g(i) * b.f(i));
+        if (subtract_one)
+          overlap[k] += cw * (a.f(i) * b.f(i) + a.g(i) * b.g(i));
+      }
+    }
+
+    // me_k(q) = sum_r jL(q,r) * rho(r, k): use only r < r_max part of table
+    LinAlg::Matrix<double> me_k(num_q, index.size());
+    const auto &jLq = m_j_lq_r->at(L);
+    LinAlg::backend::gemm(num_q, index.size(), r_max, jLq[0], jLq.cols(),
+                          rho.data(), rho.cols(), me_k.data(), me_k.cols());
+
+    for (std::size_t iq = 0; iq < num_q; ++iq) {
+      for (std::size_t k = 0; k < index.size(); ++k) {
+        me(iq, index[k]) = me_k(iq, k) - overlap[k];
+      }
+    }
+    return me;
+  }
+
   //! Checks if specific ME is zero (when not useing set_L_q)
   bool is_zero(const DiracSpinor &a, const DiracSpinor &b,
                std::size_t L) const {
@@ -234,8 +370,8 @@ public:
 class g0jL : public jL {
 public:
   g0jL(const Grid &r_grid, const Grid &q_grid, std::size_t max_l,
-       bool subtract_one = false)
-      : jL(r_grid, q_grid, max_l, subtract_one) {}
+       bool subtract_one = false, std::size_t max_pt = 0)
+      : jL(r_grid, q_grid, max_l, subtract_one, max_pt) {}
   g0jL(const jL &other) : jL(other) {}
 
 public:
@@ -251,8 +387,9 @@ public:
 //! Matrix element of tensor operator: i gamma^5 J_L(qr) C^L. nb: i makes ME real
 class ig5jL : public jL {
 public:
-  ig5jL(const Grid &r_grid, const Grid &q_grid, std::size_t max_l)
-      : jL(r_grid, q_grid, max_l, false) {}
+  ig5jL(const Grid &r_grid, const Grid &q_grid, std::size_t max_l,
+        std::size_t max_pt = 0)
+      : jL(r_grid, q_grid, max_l, false, max_pt) {}
   ig5jL(const jL &other) : jL(other) {}
 
 public:
@@ -261,8 +398,7 @@ public:
     m_rank = int(L);
     // Note: opposite parity for 'pseudo' cases
     m_parity = Angular::evenQ(m_rank) ? Parity::odd : Parity::even;
-    const auto iq = m_q_grid->getIndex(q);
-    m_vec = m_j_lq_r.at(L, iq);
+    set_vec(L, q);
   }
 
   double angularF(const int ka, const int kb) const override final {
@@ -281,8 +417,9 @@ public:
 //! Matrix element of tensor operator: i gamma^0gamma^5 J_L(qr) C^L. nb: i makes ME real
 class ig0g5jL : public jL {
 public:
-  ig0g5jL(const Grid &r_grid, const Grid &q_grid, std::size_t max_l)
-      : jL(r_grid, q_grid, max_l, false) {}
+  ig0g5jL(const Grid &r_grid, const Grid &q_grid, std::size_t max_l,
+          std::size_t max_pt = 0)
+      : jL(r_grid, q_grid, max_l, false, max_pt) {}
   ig0g5jL(const jL &other) : jL(other) {}
 
 public:
@@ -291,8 +428,7 @@ public:
     m_rank = int(L);
     // Note: opposite parity for 'pseudo' cases
     m_parity = Angular::evenQ(m_rank) ? Parity::odd : Parity::even;
-    const auto iq = m_q_grid->getIndex(q);
-    m_vec = m_j_lq_r.at(L, iq);
+    set_vec(L, q);
   }
 
   virtual double angularF(const int ka, const int kb) const override {
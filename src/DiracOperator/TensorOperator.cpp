@@ -97,14 +97,14 @@ DiracSpinor TensorOperator::radial_rhs(const int kappa_a,
     return dF;
   }
 
-  const auto &df =
-      (m_diff_order == 0) ?
-          Fb.f() :
-          NumCalc::derivative(Fb.f(), gr.drdu(), gr.du(), m_diff_order);
-  const auto &dg =
-      (m_diff_order == 0) ?
-          Fb.g() :
-          NumCalc::derivative(Fb.g(), gr.drdu(), gr.du(), m_diff_order);
+  // nb: both branches are lvalues, so Fb is not copied when m_diff_order=0
+  std::vector<double> dFb_f, dFb_g;
+  if (m_diff_order != 0) {
+    dFb_f = NumCalc::derivative(Fb.f(), gr.drdu(), gr.du(), m_diff_order);
+    dFb_g = NumCalc::derivative(Fb.g(), gr.drdu(), gr.du(), m_diff_order);
+  }
+  const auto &df = (m_diff_order == 0) ? Fb.f() : dFb_f;
+  const auto &dg = (m_diff_order == 0) ? Fb.g() : dFb_g;
 
   const auto cff = angularCff(kappa_a, Fb.kappa());
   const auto cgg = angularCgg(kappa_a, Fb.kappa());
@@ -147,14 +147,14 @@ double TensorOperator::radialIntegral(const DiracSpinor &Fa,
   const auto p0 = std::max(Fa.min_pt(), Fb.min_pt());
   const auto pf = std::min(Fa.max_pt(), Fb.max_pt());
 
-  const auto &df =
-      (m_diff_order == 0) ?
-          Fb.f() :
-          NumCalc::derivative(Fb.f(), gr.drdu(), gr.du(), m_diff_order);
-  const auto &dg =
-      (m_diff_order == 0) ?
-          Fb.g() :
-          NumCalc::derivative(Fb.g(), gr.drdu(), gr.du(), m_diff_order);
+  // nb: both branches are lvalues, so Fb is not copied when m_diff_order=0
+  std::vector<double> dFb_f, dFb_g;
+  if (m_diff_order != 0) {
+    dFb_f = NumCalc::derivative(Fb.f(), gr.drdu(), gr.du(), m_diff_order);
+    dFb_g = NumCalc::derivative(Fb.g(), gr.drdu(), gr.du(), m_diff_order);
+  }
+  const auto &df = (m_diff_order == 0) ? Fb.f() : dFb_f;
+  const auto &dg = (m_diff_order == 0) ? Fb.g() : dFb_g;
 
   const auto cff = angularCff(kappa_a, Fb.kappa());
   const auto cgg = angularCgg(kappa_a, Fb.kappa());
@@ -1,6 +1,7 @@
 #pragma once
 #include "DiracOperator/TensorOperator.hpp"
 #include "qip/String.hpp"
+#include <functional>
 #include <string>
 #include <vector>
 class DiracSpinor;
@@ -61,6 +62,27 @@ public:
   virtual void solve_core(const double omega, int max_its = 100,
                           const bool print = true) = 0;
 
+  //! Called by solve_sweep() as f(rpa, i), once rpa is solved at omegas[i]
+  using SweepFunction =
+      std::function<void(const CorePolarisation &, std::size_t)>;
+
+  //! @brief Solves RPA for each frequency in omegas, calling f(rpa, i) for
+  //! each solution.
+  /*! @details Each solve is started from the neighbouring solution, so
+  omegas should be ordered. rpa is *this, or a copy of *this of the same
+  type. Derived classes may solve independent chunks of omegas in parallel
+  (then f is called concurrently, for different i), so f must be thread-safe.
+  On return, *this holds the solution for omegas.back().
+  */
+  virtual void solve_sweep(const std::vector<double> &omegas,
+                           const SweepFunction &f, int max_its = 100,
+                           const bool print = false) {
+    for (std::size_t i = 0; i < omegas.size(); ++i) {
+      solve_core(omegas[i], max_its, print);
+      f(*this, i);
+    }
+  }
+
   //! @brief Clears the dPsi orbitals (sets to zero)
   virtual void clear() = 0;
 
@@ -9,14 +9,74 @@
 #include "HF/HartreeFock.hpp"
 #include "IO/ChronoTimer.hpp"
 #include "IO/FRW_fileReadWrite.hpp"
+#include "IO/Profile.hpp"
+#include "LinAlg/Vector.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
 #include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace ExternalField {
 
+//==============================================================================
+namespace {
+
+// Process-wide cache of W matrices: {basis hash, rank, parity, Breit scale}
+using WKey = std::tuple<std::uint64_t, int, int, double>;
+using WPtr = std::shared_ptr<const LinAlg::Matrix<double>>;
+
+std::mutex &W_cache_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<WKey, WPtr> &W_cache() {
+  static std::map<WKey, WPtr> cache;
+  return cache;
+}
+
+// FNV-1a; stable between runs/platforms (so may be stored in file)
+void hash_bytes(std::uint64_t &hash, const void *data, std::size_t num_bytes) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < num_bytes; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+std::uint64_t basis_hash(const std::vector<DiracSpinor> &holes,
+                         const std::vector<DiracSpinor> &excited) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (const auto porbs : {&holes, &excited}) {
+    const auto size = porbs->size();
+    hash_bytes(hash, &size, sizeof(size));
+    for (const auto &Fn : *porbs) {
+      const int nk[2] = {Fn.n(), Fn.kappa()};
+      const auto en = Fn.en();
+      hash_bytes(hash, nk, sizeof(nk));
+      hash_bytes(hash, &en, sizeof(en));
+      hash_bytes(hash, Fn.f().data(), Fn.f().size() * sizeof(double));
+      hash_bytes(hash, Fn.g().data(), Fn.g().size() * sizeof(double));
+    }
+  }
+  return hash;
+}
+
+} // namespace
+
+//==============================================================================
+std::size_t DiagramRPA::clear_W_cache() {
+  std::lock_guard<std::mutex> lock(W_cache_mutex());
+  const auto size = W_cache().size();
+  W_cache().clear();
+  return size;
+}
+
 //==============================================================================
 DiagramRPA::DiagramRPA(const DiracOperator::TensorOperator *const h,
                        const std::vector<DiracSpinor> &basis,
@@ -43,19 +103,43 @@ DiagramRPA::DiagramRPA(const DiracOperator::TensorOperator *const h,
   }
 
   // Calc t0 (and setup t) [RPA MEs for hole-excited]
+  setup_pairs(h);
   setup_ts(h);
 
-  const auto basis_string = DiracSpinor::state_config(basis);
-
-  const auto fname = atom + "_" + std::to_string(m_rank) +
-                     (m_pi == 1 ? "+" : "-") + "_" + basis_string + ".rpad.abf";
-
   // Setup faster Breit
   if (p_hf->vBreit() != nullptr) {
     m_Br = *p_hf->vBreit();
     m_Br->fill_gb(basis);
   }
 
+  if (holes.empty() || excited.empty()) {
+    std::cout << "\nWARNING 64 in DiagramRPA: no basis! RPA will be zero\n";
+    return;
+  }
+
+  // W depends only on basis, rank, parity (and Breit): first, check if it
+  // has already been calculated (e.g., by another module)
+  m_basis_hash = basis_hash(holes, excited);
+  const WKey key{m_basis_hash, m_rank, m_pi, breit_scale()};
+  {
+    std::lock_guard<std::mutex> lock(W_cache_mutex());
+    const auto it = W_cache().find(key);
+    if (it != W_cache().end())
+      m_W = it->second;
+  }
+  if (m_W) {
+    std::cout << "Re-using RPA(diagram) W matrix ("
+              << DiracSpinor::state_config(holes) << "/"
+              << DiracSpinor::state_config(excited) << ", k=" << m_rank
+              << (m_pi == 1 ? "+" : "-") << ")\n";
+    return;
+  }
+
+  const auto basis_string = DiracSpinor::state_config(basis);
+  const auto fname = atom + "_" + std::to_string(m_rank) +
+                     (m_pi == 1 ? "+" : "-") + "_" + basis_string +
+                     (m_Br ? "_Br" : "") + ".rpad.abf";
+
   // if constexpr (m_USE_QK) {
   //   std::cout << "\nFill Qk table:\n";
   //   const auto ok = m_qk.read(fname);
@@ -68,13 +152,17 @@ DiagramRPA::DiagramRPA(const DiracOperator::TensorOperator *const h,
   // } else {
 
   // Attempt to read W's from a file:
-  const auto read_ok = read_write(fname, IO::FRW::read);
+  const auto read_ok = atom != "" && read_write(fname, IO::FRW::read);
   if (!read_ok) {
     // If not, calc W's, and write to file
-    fill_W_matrix(h);
-    if (!holes.empty() && !excited.empty() && atom != "")
+    fill_W_matrix();
+    if (atom != "")
       read_write(fname, IO::FRW::write);
   }
+
+  // Store in cache. If another thread got there first, use that one
+  std::lock_guard<std::mutex> lock(W_cache_mutex());
+  m_W = W_cache().emplace(key, m_W).first->second;
 }
 
 //==============================================================================
@@ -91,17 +179,30 @@ DiagramRPA::DiagramRPA(const DiracOperator::TensorOperator *const h,
   // Set up basis:
   holes = drpa->holes;
   excited = drpa->excited;
+  m_am = drpa->m_am;
+  m_Br = drpa->m_Br;
+  m_basis_hash = drpa->m_basis_hash;
 
   setup_ts(h);
 
   // "eat" W matrices from other rpa
-  Wanmb = drpa->Wanmb;
-  Wabmn = drpa->Wabmn;
-  Wmnab = drpa->Wmnab;
-  Wmban = drpa->Wmban;
+  m_W = drpa->m_W;
   // m_qk = drpa->m_qk;
 }
 
+//==============================================================================
+void DiagramRPA::setup_pairs(const DiracOperator::TensorOperator *const h) {
+  // Only {a,m} pairs allowed by selection rules contribute; the rest have
+  // t_am = 0 always, and are not stored
+  m_am.clear();
+  for (std::size_t ia = 0; ia < holes.size(); ++ia) {
+    for (std::size_t im = 0; im < excited.size(); ++im) {
+      if (!h->isZero(holes[ia].kappa(), excited[im].kappa()))
+        m_am.emplace_back(ia, im);
+    }
+  }
+}
+
 //==============================================================================
 bool DiagramRPA::read_write(const std::string &fname, IO::FRW::RoW rw) {
   // Note: only writes W (depends on k/pi, and basis). Do not write t's, since
@@ -129,6 +230,16 @@ bool DiagramRPA::read_write(const std::string &fname, IO::FRW::RoW rw) {
     return false;
   }
 
+  // Layout of W changed (v3: flat matrix, with basis hash + Breit); don't
+  // attempt to read old files
+  std::string version = "DiagramRPA:W:v3";
+  rw_binary(iofs, rw, version);
+  if (readQ && version != "DiagramRPA:W:v3") {
+    std::cout << "\nCannot read from " << fname << ". Old file format.\n"
+              << "Will recalculate rpa_Diagram matrix, and overwrite file.\n";
+    return false;
+  }
+
   // Note: Basis states must match exactly (since use their index across arrays)
   // Check if same. If not, print status and calc W from scratch
 
@@ -162,15 +273,43 @@ bool DiagramRPA::read_write(const std::string &fname, IO::FRW::RoW rw) {
     }
   }
 
-  // read/write Ws:
-  rw_binary(iofs, rw, Wanmb, Wabmn, Wmnab, Wmban);
+  // Orbitals (not just their labels) must match, as must Breit
+  auto hash = m_basis_hash;
+  auto br_scale = breit_scale();
+  rw_binary(iofs, rw, hash, br_scale);
+  if (readQ && (hash != m_basis_hash || br_scale != breit_scale())) {
+    std::cout << "\nCannot read from " << fname
+              << ". Basis or Breit mis-match (orbitals differ).\n"
+              << "Will recalculate rpa_Diagram matrix, and overwrite file.\n";
+    return false;
+  }
+
+  // read/write W: stored as single contiguous block
+  std::size_t rows = m_W ? m_W->rows() : 0, cols = m_W ? m_W->cols() : 0;
+  rw_binary(iofs, rw, rows, cols);
+  if (readQ) {
+    if (rows != 2 * m_am.size() || cols != 2 * m_am.size()) {
+      std::cout << "\nCannot read from " << fname << ". W mis-match (read "
+                << rows << "x" << cols << "; expected " << 2 * m_am.size()
+                << ").\n"
+                << "Will recalculate rpa_Diagram matrix, and overwrite file.\n";
+      return false;
+    }
+    auto W = std::make_shared<LinAlg::Matrix<double>>(rows, cols);
+    iofs.read(reinterpret_cast<char *>(W->data()),
+              long(W->size() * sizeof(double)));
+    m_W = std::move(W);
+  } else {
+    iofs.write(reinterpret_cast<const char *>(m_W->data()),
+               long(m_W->size() * sizeof(double)));
+  }
   std::cout << "done.\n";
 
   return true;
 }
 
 //==============================================================================
-void DiagramRPA::fill_W_matrix(const DiracOperator::TensorOperator *const h) {
+void DiagramRPA::fill_W_matrix() {
   if (holes.empty() || excited.empty()) {
     std::cout << "\nWARNING 64 in DiagramRPA: no basis! RPA will be zero\n";
     return;
@@ -186,101 +325,38 @@ void DiagramRPA::fill_W_matrix(const DiracOperator::TensorOperator *const h) {
   std::cout << "Filling RPA Diagram matrix ("
             << DiracSpinor::state_config(holes) << "/"
             << DiracSpinor::state_config(excited) << ") .. " << std::flush;
-  Wanmb.resize(holes.size());
-  Wabmn.resize(holes.size());
-  // First set: only use Yhe and Yee
-  {
-    const auto &Yee = Yhe;
-#pragma omp parallel for
-    for (std::size_t i = 0; i < holes.size(); i++) {
-      const auto &Fa = holes[i];
-      auto &Wa_nmb = Wanmb[i];
-      auto &Wa_bmn = Wabmn[i];
-      Wa_nmb.reserve(excited.size());
-      Wa_bmn.reserve(excited.size());
-      for (const auto &Fn : excited) {
-        auto &Wan_mb = Wa_nmb.emplace_back();
-        auto &Wab_mn = Wa_bmn.emplace_back();
-        Wan_mb.reserve(excited.size());
-        Wab_mn.reserve(excited.size());
-        for (const auto &Fm : excited) {
-          auto &Wanm_b = Wan_mb.emplace_back();
-          auto &Wabm_n = Wab_mn.emplace_back();
-          Wanm_b.reserve(holes.size());
-          Wabm_n.reserve(holes.size());
-          for (const auto &Fb : holes) {
-            if (h->isZero(Fb.kappa(), Fn.kappa())) {
-              Wanm_b.emplace_back(0.0);
-              Wabm_n.emplace_back(0.0);
-              continue;
-            }
-            const auto xQ = Yhe.Q(m_rank, Fa, Fn, Fm, Fb);
-            const auto xP = Yee.P(m_rank, Fa, Fn, Fm, Fb);
-            const auto yQ = Yee.Q(m_rank, Fa, Fb, Fm, Fn);
-            const auto yP = Yhe.P(m_rank, Fa, Fb, Fm, Fn);
-            // Breit Contribution to core:
-            const auto xB =
-                m_Br ? m_Br->BWk_abcd_2(m_rank, Fa, Fn, Fm, Fb) : 0.0;
-            const auto yB =
-                m_Br ? m_Br->BWk_abcd_2(m_rank, Fa, Fb, Fm, Fn) : 0.0;
-
-            Wanm_b.push_back(xQ + xP + xB);
-            Wabm_n.push_back(yQ + yP + yB);
-          }
-        }
-      }
-    }
-  }
 
-  Wmnab.resize(excited.size());
-  Wmban.resize(excited.size());
-  std::cout << "." << std::flush;
-  {
-    // Only use Yhe and Yhh here:
-    // const Coulomb::YkTable Yhh(holes);
-    const auto &Yhh = Yhe;
-#pragma omp parallel for
-    for (std::size_t i = 0; i < excited.size(); i++) {
-      const auto &Fm = excited[i];
-      auto &Wa_nmb = Wmnab[i];
-      auto &Wa_bmn = Wmban[i];
-      Wa_nmb.reserve(excited.size());
-      Wa_bmn.reserve(excited.size());
-      for (const auto &Fn : excited) {
-        auto &Wan_mb = Wa_nmb.emplace_back();
-        auto &Wab_mn = Wa_bmn.emplace_back();
-        Wan_mb.reserve(holes.size());
-        Wab_mn.reserve(holes.size());
-        for (const auto &Fa : holes) {
-          auto &Wanm_b = Wan_mb.emplace_back();
-          auto &Wabm_n = Wab_mn.emplace_back();
-          Wanm_b.reserve(holes.size());
-          Wabm_n.reserve(holes.size());
-          for (const auto &Fb : holes) {
-            if (h->isZero(Fb.kappa(), Fn.kappa())) {
-              // do I need to store the zero's? Or can I skip them below?
-              // skipping is dangerous, mis-match of indexes
-              // However, we roughly store 2x what we need!
-              Wanm_b.emplace_back(0.0);
-              Wabm_n.emplace_back(0.0);
-              continue;
-            }
-            const auto xQ = Yhe.Q(m_rank, Fm, Fn, Fa, Fb);
-            const auto xP = Yhe.P(m_rank, Fm, Fn, Fa, Fb);
-            const auto yQ = Yhe.Q(m_rank, Fm, Fb, Fa, Fn);
-            const auto yP = Yhh.P(m_rank, Fm, Fb, Fa, Fn);
-            // nb: Breit part not double-checked! XXX
-            const auto xB =
-                m_Br ? m_Br->BWk_abcd_2(m_rank, Fm, Fn, Fa, Fb) : 0.0;
-            const auto yB =
-                m_Br ? m_Br->BWk_abcd_2(m_rank, Fm, Fb, Fa, Fn) : 0.0;
-            Wanm_b.push_back(xQ + xP + xB);
-            Wabm_n.push_back(yQ + yP + yB);
-          }
-        }
-      }
+  // Only use Yhe, Yee, and Yhh (all stored in Yhe)
+  const auto &Y = Yhe;
+  // W = Q + P (+ Breit contribution to core)
+  // nb: Breit part for W_mnab, W_mban not double-checked! XXX
+  const auto W = [&](const DiracSpinor &F1, const DiracSpinor &F2,
+                     const DiracSpinor &F3, const DiracSpinor &F4) {
+    return Y.Q(m_rank, F1, F2, F3, F4) + Y.P(m_rank, F1, F2, F3, F4) +
+           (m_Br ? m_Br->BWk_abcd_2(m_rank, F1, F2, F3, F4) : 0.0);
+  };
+
+  const auto P = m_am.size();
+  auto Wmat = std::make_shared<LinAlg::Matrix<double>>(2 * P, 2 * P);
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t p = 0; p < P; ++p) {
+    const auto &Fa = holes[m_am[p].first];
+    const auto &Fm = excited[m_am[p].second];
+    auto *W_am = (*Wmat)[p];
+    auto *W_ma = (*Wmat)[P + p];
+    for (std::size_t q = 0; q < P; ++q) {
+      const auto &Fb = holes[m_am[q].first];
+      const auto &Fn = excited[m_am[q].second];
+      const auto s1 = ((Fb.twoj() - Fa.twoj() + 2 * m_rank) % 4 == 0) ? 1 : -1;
+      const auto s3 = ((Fb.twoj() - Fm.twoj() + 2 * m_rank) % 4 == 0) ? 1 : -1;
+
+      W_am[q] = s1 * W(Fa, Fn, Fm, Fb);
+      W_am[P + q] = s1 * W(Fa, Fb, Fm, Fn);
+      W_ma[q] = s3 * W(Fm, Fn, Fa, Fb);
+      W_ma[P + q] = s3 * W(Fm, Fb, Fa, Fn);
     }
   }
+  m_W = std::move(Wmat);
   std::cout << " done.\n" << std::flush;
 }
 
@@ -292,24 +368,12 @@ void DiagramRPA::setup_ts(const DiracOperator::TensorOperator *const h) {
   t0am.clear();
   t0ma.clear();
 
-  t0am.reserve(holes.size());
-  t0ma.reserve(excited.size());
+  t0am.reserve(m_am.size());
+  t0ma.reserve(m_am.size());
   // Calc t0 (and setup t)
-  for (const auto &Fa : holes) {
-    std::vector<double> t0a_m;
-    t0a_m.reserve(excited.size());
-    for (const auto &Fm : excited) {
-      t0a_m.push_back(h->reducedME(Fa, Fm));
-    }
-    t0am.push_back(t0a_m);
-  }
-  for (const auto &Fm : excited) {
-    std::vector<double> t0m_a;
-    t0m_a.reserve(holes.size());
-    for (const auto &Fa : holes) {
-      t0m_a.push_back(h->reducedME(Fm, Fa));
-    }
-    t0ma.push_back(t0m_a);
+  for (const auto &[ia, im] : m_am) {
+    t0am.push_back(h->reducedME(holes[ia], excited[im]));
+    t0ma.push_back(h->reducedME(excited[im], holes[ia]));
   }
   clear();
 }
@@ -327,21 +391,13 @@ void DiagramRPA::update_t0s(const DiracOperator::TensorOperator *const h) {
     assert(h->imaginaryQ() == m_imag && "Imaginarity must match in update_t0s");
     m_h = h;
   }
-  assert(t0am.size() == holes.size());
-  assert(t0ma.size() == excited.size());
-  if (holes.size() > 0) {
-    assert(t0am.at(0).size() == excited.size());
-  }
-  if (excited.size() > 0) {
-    assert(t0ma.at(0).size() == holes.size());
-  }
-  for (std::size_t ia = 0; ia < holes.size(); ++ia) {
-    const auto &Fa = holes[ia];
-    for (std::size_t im = 0; im < excited.size(); ++im) {
-      const auto &Fm = excited[im];
-      t0am[ia][im] = m_h->reducedME(Fa, Fm);
-      t0ma[im][ia] = m_h->symm_sign(Fa, Fm) * t0am[ia][im];
-    }
+  assert(t0am.size() == m_am.size());
+  assert(t0ma.size() == m_am.size());
+  for (std::size_t p = 0; p < m_am.size(); ++p) {
+    const auto &Fa = holes[m_am[p].first];
+    const auto &Fm = excited[m_am[p].second];
+    t0am[p] = m_h->reducedME(Fa, Fm);
+    t0ma[p] = m_h->symm_sign(Fa, Fm) * t0am[p];
   }
   clear();
 }
@@ -373,127 +429,144 @@ double DiagramRPA::dV_diagram(const DiracSpinor &Fw,
 
   const auto f = (1.0 / (2 * m_rank + 1));
 
-  std::vector<double> sum_a(holes.size());
+  std::vector<double> sum_am(m_am.size());
 #pragma omp parallel for
-  for (std::size_t ia = 0; ia < holes.size(); ia++) {
-    const auto &Fa = holes[ia];
+  for (std::size_t p = 0; p < m_am.size(); p++) {
+    if (t0am[p] == 0.0)
+      continue;
+    const auto &Fa = holes[m_am[p].first];
+    const auto &Fm = excited[m_am[p].second];
     const auto s1 = ((Fa.twoj() - Ff.twoj() + 2 * m_rank) % 4 == 0) ? 1 : -1;
-    for (std::size_t im = 0; im < excited.size(); im++) {
-      const auto &Fm = excited[im];
-      if (t0am[ia][im] == 0.0)
-        continue;
-      const auto s2 = ((Fa.twoj() - Fm.twoj()) % 4 == 0) ? 1 : -1;
-      // Calculate Wk from scratch here: Fi/Ff may be valence.
-      const auto Wwmva =
-          Coulomb::Wk_abcd(m_rank, Ff, Fm, Fi, Fa) +
-          (m_Br ? m_Br->BWk_abcd_2(m_rank, Ff, Fm, Fi, Fa) : 0.0);
-      const auto Wwavm =
-          Coulomb::Wk_abcd(m_rank, Ff, Fa, Fi, Fm) +
-          (m_Br ? m_Br->BWk_abcd_2(m_rank, Ff, Fa, Fi, Fm) : 0.0);
-      const auto ttam = tam[ia][im];
-      const auto ttma = tma[im][ia];
-      const auto A = ttam * Wwmva / (Fa.en() - Fm.en() - ww);
-      const auto B = Wwavm * ttma / (Fa.en() - Fm.en() + ww);
-      sum_a[ia] += s1 * (A + s2 * B);
-    }
+    const auto s2 = ((Fa.twoj() - Fm.twoj()) % 4 == 0) ? 1 : -1;
+    // Calculate Wk from scratch here: Fi/Ff may be valence.
+    const auto Wwmva = Coulomb::Wk_abcd(m_rank, Ff, Fm, Fi, Fa) +
+                       (m_Br ? m_Br->BWk_abcd_2(m_rank, Ff, Fm, Fi, Fa) : 0.0);
+    const auto Wwavm = Coulomb::Wk_abcd(m_rank, Ff, Fa, Fi, Fm) +
+                       (m_Br ? m_Br->BWk_abcd_2(m_rank, Ff, Fa, Fi, Fm) : 0.0);
+    const auto A = tam[p] * Wwmva / (Fa.en() - Fm.en() - ww);
+    const auto B = Wwavm * tma[p] / (Fa.en() - Fm.en() + ww);
+    sum_am[p] = s1 * (A + s2 * B);
   }
-  return f * std::accumulate(begin(sum_a), end(sum_a), 0.0);
+  return f * std::accumulate(begin(sum_am), end(sum_am), 0.0);
 }
 
 //==============================================================================
 void DiagramRPA::solve_core(const double omega, int max_its, const bool print) {
+  solve_core({this}, {omega}, max_its, print);
+}
 
-  m_core_omega = std::abs(omega);
-
-  if (holes.empty() || excited.empty())
+//------------------------------------------------------------------------------
+void DiagramRPA::solve_core(const std::vector<DiagramRPA *> &rpas,
+                            const std::vector<double> &omegas, int max_its,
+                            const bool print) {
+  IO::Profile::Region profile("RPA (diagram)");
+  assert(rpas.size() == omegas.size());
+  if (rpas.empty())
     return;
 
-  if (m_h->freqDependantQ()) {
-    // m_h->updateFrequency(m_core_omega); // Cant, is const. must do outside
-    setup_ts(m_h);
+  const auto P = rpas.front()->m_am.size();
+  for (auto *rpa : rpas) {
+    if (rpa->m_rank != rpas.front()->m_rank ||
+        rpa->m_pi != rpas.front()->m_pi || rpa->m_am.size() != P) {
+      std::cerr << "\nFAIL in DiagramRPA::solve_core: all RPAs must have same "
+                   "rank, parity, and basis\n";
+      std::abort();
+    }
+  }
+
+  // Set up each; those with no basis are done
+  std::vector<DiagramRPA *> active;
+  for (std::size_t j = 0; j < rpas.size(); ++j) {
+    auto *rpa = rpas[j];
+    rpa->m_core_omega = std::abs(omegas[j]);
+    if (rpa->holes.empty() || rpa->excited.empty())
+      continue;
+    if (rpa->m_h->freqDependantQ()) {
+      // m_h->updateFrequency(m_core_omega); // Cant, is const. must do outside
+      rpa->setup_ts(rpa->m_h);
+    }
+    if (print && rpas.size() == 1) {
+      printf("RPA(D) %s (w=%.3f): ", rpa->m_h->name().c_str(), omegas[j]);
+      std::cout << std::flush;
+    }
+    active.push_back(rpa);
   }
+  if (active.empty())
+    return;
 
-  if (print) {
-    printf("RPA(D) %s (w=%.3f): ", m_h->name().c_str(), omega);
-    std::cout << std::flush;
+  const auto &front = *active.front();
+  const auto &W = *front.m_W;
+  const auto f = (1.0 / (2 * front.m_rank + 1));
+
+  // Energy denominators, and s2 sign, for each {b,n} pair
+  std::vector<double> de(P);
+  std::vector<int> s2(P);
+  for (std::size_t q = 0; q < P; ++q) {
+    const auto &Fb = front.holes[front.m_am[q].first];
+    const auto &Fn = front.excited[front.m_am[q].second];
+    de[q] = Fb.en() - Fn.en();
+    s2[q] = ((Fb.twoj() - Fn.twoj()) % 4 == 0) ? 1 : -1;
   }
 
+  // Columns of X (and Y=W*X) correspond to each (unconverged) RPA
   int it = 0;
-  auto eps = 0.0;
-  const auto f = (1.0 / (2 * m_rank + 1));
-  for (; it < max_its; it++) {
-    std::vector<double> eps_m(excited.size()); //"thread-safe" eps..?
-// XXX "Small" race condition in here???
-#pragma omp parallel for
-    for (std::size_t im = 0; im < excited.size(); im++) {
-      const auto &Fm = excited[im];
-      double eps_worst_a = 0.0;
-      for (std::size_t ia = 0; ia < holes.size(); ia++) {
-        const auto &Fa = holes[ia];
-
-        double sum_am = 0.0;
-        double sum_ma = 0.0;
-
-        // Can replace this with dV?? NO. 1) it calcs W (since valence)
-        // 2) not thread safe
-        for (std::size_t ib = 0; ib < holes.size(); ib++) {
-          const auto &Fb = holes[ib];
-          const auto s1 =
-              ((Fb.twoj() - Fa.twoj() + 2 * m_rank) % 4 == 0) ? 1 : -1;
-          const auto s3 =
-              ((Fb.twoj() - Fm.twoj() + 2 * m_rank) % 4 == 0) ? 1 : -1;
-          for (std::size_t in = 0; in < excited.size(); in++) {
-            const auto &Fn = excited[in];
-
-            const auto tbn = tam[ib][in];
-            if (tbn == 0.0)
-              continue;
-            const auto tnb = tma[in][ib];
-            const auto tdem = tbn / (Fb.en() - Fn.en() - m_core_omega);
-            const auto s2 = ((Fb.twoj() - Fn.twoj()) % 4 == 0) ? 1 : -1;
-            const auto stdep = s2 * tnb / (Fb.en() - Fn.en() + m_core_omega);
-            // if constexpr (m_USE_QK) {
-            //   const auto A = tdem * m_qk.W(m_rank, Fa, Fn, Fm, Fb);
-            //   const auto B = stdep * m_qk.W(m_rank, Fa, Fb, Fm, Fn);
-            //   const auto C = tdem * m_qk.W(m_rank, Fm, Fn, Fa, Fb);
-            //   const auto D = stdep * m_qk.W(m_rank, Fm, Fb, Fa, Fn);
-            //   sum_am += s1 * (A + B);
-            //   sum_ma += s3 * (C + D);
-            // } else
-            {
-              const auto A = tdem * Wanmb[ia][in][im][ib];
-              const auto B = stdep * Wabmn[ia][in][im][ib];
-              const auto C = tdem * Wmnab[im][in][ia][ib];
-              const auto D = stdep * Wmban[im][in][ia][ib];
-              sum_am += s1 * (A + B);
-              sum_ma += s3 * (C + D);
-            }
-          }
-        }
+  for (; it < max_its && !active.empty(); it++) {
+    const auto N = active.size();
+    LinAlg::Matrix<double> X(2 * P, N);
+    for (std::size_t j = 0; j < N; ++j) {
+      const auto *rpa = active[j];
+      const auto w = rpa->m_core_omega;
+      for (std::size_t q = 0; q < P; ++q) {
+        X[q][j] = rpa->tam[q] / (de[q] - w);
+        X[P + q][j] = s2[q] * rpa->tma[q] / (de[q] + w);
+      }
+    }
 
-        const auto prev = tam[ia][im];
-        // 0.5 factor is for damping. f*sum is dV
-        tam[ia][im] = 0.5 * (tam[ia][im] + t0am[ia][im] + f * sum_am);
-        tma[im][ia] = 0.5 * (tma[im][ia] + t0ma[im][ia] + f * sum_ma);
-        const auto delta = std::abs((tam[ia][im] - prev) / tam[ia][im]);
-        if (delta > eps_worst_a)
-          eps_worst_a = delta;
-      } // a (holes)
-      eps_m[im] = eps_worst_a;
-    } // m (excited)
-    // XXX "small" race condition somewhere regarding eps??
-    // The itteraion it converges on always seems to be the same..
-    // but the value for eps printed changes slightly each run???
-    eps = *std::max_element(cbegin(eps_m), cend(eps_m));
-    if (eps < eps_targ)
-      break;
+    // Y = W * X; single dgemv (one RPA) or dgemm. f*Y is dV
+    const LinAlg::Matrix<double> Y =
+        N == 1 ? W * LinAlg::Vector<double>(std::move(X)) : W * X;
+
+    // Update t's (damped, 0.5 factor), using only previous t's
+    std::vector<DiagramRPA *> still_active;
+    for (std::size_t j = 0; j < N; ++j) {
+      auto *rpa = active[j];
+      double eps = 0.0;
+      for (std::size_t p = 0; p < P; ++p) {
+        const auto prev = rpa->tam[p];
+        rpa->tam[p] = 0.5 * (rpa->tam[p] + rpa->t0am[p] + f * Y[p][j]);
+        rpa->tma[p] = 0.5 * (rpa->tma[p] + rpa->t0ma[p] + f * Y[P + p][j]);
+        const auto delta = std::abs((rpa->tam[p] - prev) / rpa->tam[p]);
+        if (delta > eps)
+          eps = delta;
+      }
+      rpa->m_core_eps = eps;
+      rpa->m_core_its = it;
+      if (eps < rpa->eps_targ) {
+        if (print) {
+          if (rpas.size() > 1)
+            printf("RPA(D) %s (w=%.3f): ", rpa->m_h->name().c_str(),
+                   rpa->m_core_omega);
+          printf("%2i %.1e\n", it, eps);
+          std::cout << std::flush;
+        }
+      } else {
+        still_active.push_back(rpa);
+      }
+    }
+    active = std::move(still_active);
   } // its
-  if (print) {
-    printf("%2i %.1e\n", it, eps);
-    std::cout << std::flush;
+
+  // Those that did not converge:
+  for (auto *rpa : active) {
+    rpa->m_core_its = it;
+    if (print) {
+      if (rpas.size() > 1)
+        printf("RPA(D) %s (w=%.3f): ", rpa->m_h->name().c_str(),
+               rpa->m_core_omega);
+      printf("%2i %.1e\n", it, rpa->m_core_eps);
+      std::cout << std::flush;
+    }
   }
-  m_core_eps = eps;
-  m_core_its = it;
 }
 
 } // namespace ExternalField
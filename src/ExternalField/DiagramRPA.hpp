@@ -3,7 +3,11 @@
 #include "Coulomb/QkTable.hpp"
 #include "HF/Breit.hpp"
 #include "IO/FRW_fileReadWrite.hpp"
+#include "LinAlg/Matrix.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 class Wavefunction;
 class DiracSpinor;
@@ -27,20 +31,30 @@ private:
 
   std::optional<HF::Breit> m_Br{};
 
+  // Hole-excited pairs {a,m} (indices into holes, excited) that are allowed
+  // by operator's rank/parity selection rules. All t's, and the rows/cols of
+  // W, are indexed by position in this list.
+  std::vector<std::pair<std::size_t, std::size_t>> m_am{};
+
   // t0's never change
   // NO! They change if omega is updated (frequency dependent operator!)
-  std::vector<std::vector<double>> t0am{};
-  std::vector<std::vector<double>> t0ma{};
+  std::vector<double> t0am{};
+  std::vector<double> t0ma{};
   // t's updated each solve_core itteration
-  std::vector<std::vector<double>> tam{};
-  std::vector<std::vector<double>> tma{};
-
-  // Note: W's depend on rank (also parity)! Can re-use!?
-  // These are probably an excellent candidate for unordered_map?
-  std::vector<std::vector<std::vector<std::vector<double>>>> Wanmb{};
-  std::vector<std::vector<std::vector<std::vector<double>>>> Wabmn{};
-  std::vector<std::vector<std::vector<std::vector<double>>>> Wmnab{};
-  std::vector<std::vector<std::vector<std::vector<double>>>> Wmban{};
+  std::vector<double> tam{};
+  std::vector<double> tma{};
+
+  // W's depend on rank (and parity) + basis only, not on the operator.
+  // Stored as single (2P)x(2P) block matrix, P = m_am.size():
+  //   [ s1*W_anmb   s1*W_abmn ]   rows: {am}, then {ma}
+  //   [ s3*W_mnab   s3*W_mban ]   cols: {bn}, then {nb}
+  // including the angular signs (s1, s3), so each RPA iteration is a single
+  // matrix-vector product (or matrix-matrix for several operators at once)
+  // Read-only, and shared between all DiagramRPAs with same {basis, k, pi,
+  // Breit} (see W_cache)
+  std::shared_ptr<const LinAlg::Matrix<double>> m_W{nullptr};
+  // Hash of the (holes, excited) basis: n, kappa, energy, and f/g
+  std::uint64_t m_basis_hash{0};
 
   // // nb: much slower to use Qk table
   // static constexpr bool m_USE_QK = false;
@@ -53,6 +67,8 @@ public:
              const HF::HartreeFock *in_hf, const std::string &atom = "Atom");
 
   //! Second constructor: copies over W matrices (depend only on k/pi)
+  //! @details Not usually required: the normal constructor already re-uses W
+  //! from any existing DiagramRPA with same basis, rank, parity, and Breit.
   DiagramRPA(const DiracOperator::TensorOperator *const h,
              const DiagramRPA *const drpa);
 
@@ -61,6 +77,14 @@ public:
   virtual void solve_core(const double omega, int max_its = 200,
                           const bool print = true) override final;
 
+  //! Itterates the RPA equations for several operators/frequencies at once.
+  //! @details All must have same rank and parity, and be built on same basis
+  //! (e.g., via the 'copy W' constructor). omegas[i] is used for rpas[i].
+  //! Each iteration is a single matrix-matrix product with the shared W.
+  static void solve_core(const std::vector<DiagramRPA *> &rpas,
+                         const std::vector<double> &omegas, int max_its = 200,
+                         const bool print = true);
+
   //! Returns RPA method
   virtual Method method() const override final { return Method::diagram; }
 
@@ -84,6 +108,16 @@ public:
     tma = drpa->tma;
   }
 
+  //! The (shared, read-only) W matrix. May be null if basis is empty
+  std::shared_ptr<const LinAlg::Matrix<double>> W() const { return m_W; }
+
+  //! @brief Releases all W matrices held by the process-wide cache.
+  //! @details W matrices are built once per {basis, rank, parity, Breit}, and
+  //! kept (by the cache) for the rest of the run, so operators of the same
+  //! rank/parity in different modules share them. Existing DiagramRPAs keep
+  //! their own W. Returns number of matrices released.
+  static std::size_t clear_W_cache();
+
 private:
   // Note: only writes W (depends on k/pi, and basis). Do not write t's, since
   // they depend on operator. This makes it very fast when making small changes
@@ -91,8 +125,10 @@ private:
   // Note: doesn't depend on grid!
   bool read_write(const std::string &fname, IO::FRW::RoW rw);
 
-  void fill_W_matrix(const DiracOperator::TensorOperator *const h);
+  void fill_W_matrix();
+  double breit_scale() const { return m_Br ? m_Br->scale_factor() : 0.0; }
   void setup_ts(const DiracOperator::TensorOperator *const h);
+  void setup_pairs(const DiracOperator::TensorOperator *const h);
 
 public:
   DiagramRPA &operator=(const DiagramRPA &) = delete;
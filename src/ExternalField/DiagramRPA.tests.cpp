@@ -31,6 +31,8 @@ TEST_CASE("External Field: Diagram RPA - basic unit tests",
   REQUIRE(F6p != nullptr);
 
   const auto file_name = "deleteme_" + qip::random_string(4);
+  // in case other tests ran first
+  ExternalField::DiagramRPA::clear_W_cache();
   auto rpa = ExternalField::DiagramRPA(&dE1, wf.basis(), wf.vHF(), file_name);
   rpa.solve_core(0.0, 20);
 
@@ -40,9 +42,28 @@ TEST_CASE("External Field: Diagram RPA - basic unit tests",
   // doesn't work with small grid/basis/its etc
   // REQUIRE(std::abs(dv_0) < std::abs(dv1_0));
 
-  // This should read W matrix from file, but not calculate t's
-  // Grabbing t's from other rpa - should yield exact same result!
+  // W is shared between all RPAs with same basis and rank/parity, even for
+  // different operators (E1 in length and velocity form)
+  auto dE1v = DiracOperator::E1v(wf.alpha(), 0.0);
+  auto rpa_v =
+      ExternalField::DiagramRPA(&dE1v, wf.basis(), wf.vHF(), file_name);
+  REQUIRE(rpa.W() != nullptr);
+  REQUIRE(rpa_v.W() == rpa.W());
+  // ..but not for different rank/parity
+  auto dE2 = DiracOperator::Ek(wf.grid(), 2);
+  auto rpa_E2 = ExternalField::DiagramRPA(&dE2, wf.basis(), wf.vHF(), "");
+  REQUIRE(rpa_E2.W() != nullptr);
+  REQUIRE(rpa_E2.W() != rpa.W());
+  // Cache holds W for E1 and E2 (each built only once)
+  REQUIRE(ExternalField::DiagramRPA::clear_W_cache() == 2);
+
+  // With the cache cleared, this should read W matrix from file, but not
+  // calculate t's. Grabbing t's from other rpa - should yield exact same
+  // result!
   auto rpa2 = ExternalField::DiagramRPA(&dE1, wf.basis(), wf.vHF(), file_name);
+  REQUIRE(rpa2.W() != rpa.W());
+  REQUIRE(std::equal(rpa2.W()->data(), rpa2.W()->data() + rpa2.W()->size(),
+                     rpa.W()->data()));
   rpa2.grab_tam(&rpa);
   // const auto dv1_2 = rpa2.dV1(*F6s, *F6p);
   const auto dv_2 = rpa2.dV(*F6s, *F6p);
@@ -61,6 +82,27 @@ TEST_CASE("External Field: Diagram RPA - basic unit tests",
   const auto dv_3 = rpa3.dV(*F6s, *F6p);
   std::cout << *F6s << "-" << *F6p << ": " << dv_3 << "\n";
   REQUIRE(dv_3 == Approx(dv_0).epsilon(1.0e-2));
+
+  // Several frequencies at once (single matrix-matrix product per iteration)
+  // should match solving each separately
+  const std::vector<double> omegas{0.0, 0.02, 0.05};
+  std::vector<ExternalField::DiagramRPA> rpas_batch, rpas_single;
+  for (std::size_t i = 0; i < omegas.size(); ++i) {
+    rpas_batch.emplace_back(&dE1, &rpa);
+    rpas_single.emplace_back(&dE1, &rpa);
+  }
+  std::vector<ExternalField::DiagramRPA *> p_rpas;
+  for (auto &r : rpas_batch) {
+    p_rpas.push_back(&r);
+  }
+  ExternalField::DiagramRPA::solve_core(p_rpas, omegas, 100);
+  for (std::size_t i = 0; i < omegas.size(); ++i) {
+    rpas_single[i].solve_core(omegas[i], 100);
+    const auto dv_batch = rpas_batch[i].dV(*F6s, *F6p);
+    const auto dv_single = rpas_single[i].dV(*F6s, *F6p);
+    REQUIRE(rpas_batch[i].get_its() == rpas_single[i].get_its());
+    REQUIRE(dv_batch == Approx(dv_single).epsilon(1.0e-10));
+  }
 }
 
 //==============================================================================
@@ -2,18 +2,23 @@
 #include "Angular/CkTable.hpp"
 #include "Angular/Wigner369j.hpp"
 #include "Coulomb/CoulombIntegrals.hpp"
+#include "DiracODE/InhomogenousGreens.hpp"
 #include "DiracOperator/TensorOperator.hpp"
 #include "ExternalField/MixedStates.hpp"
 #include "HF/Breit.hpp"
 #include "HF/HartreeFock.hpp"
 #include "IO/ChronoTimer.hpp"
+#include "IO/Profile.hpp"
+#include "LinAlg/Solvers.hpp"
 #include "MBPT/CorrelationPotential.hpp"
 #include "Wavefunction/BSplineBasis.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
 #include "Wavefunction/Wavefunction.hpp"
+#include "qip/omp.hpp"
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 namespace ExternalField {
@@ -278,6 +283,13 @@ std::pair<double, std::string> TDHF::tdhf_core_it(double omega,
 
 //==============================================================================
 void TDHF::solve_core(const double omega, int max_its, const bool print) {
+  IO::Profile::Region profile("RPA (TDHF)");
+  solve_core_impl(omega, max_its, print, 6);
+}
+
+//------------------------------------------------------------------------------
+void TDHF::solve_core_impl(double omega, int max_its, bool print,
+                           int min_its) {
   const double converge_targ = 1.0e-9;
 
   const auto eta_damp0 = 0.35;
@@ -311,7 +323,7 @@ void TDHF::solve_core(const double omega, int max_its, const bool print) {
       }
     }
 
-    if ((it > 5 && eps.first < converge_targ) || it == max_its ||
+    if ((it >= min_its && eps.first < converge_targ) || it == max_its ||
         count_worse > 5)
       break;
   }
@@ -331,6 +343,299 @@ void TDHF::solve_core(const double omega, int max_its, const bool print) {
   m_core_omega = omega;
 }
 
+//==============================================================================
+void TDHF::solve_core_krylov(const double omega, int max_its,
+                             const bool print) {
+  using namespace qip::overloads;
+  // Relative residual; squared, this is comparable to solve_core's eps
+  const double converge_targ = 3.0e-5;
+  const int restart = 50;
+  const bool staticQ = std::abs(omega) < 1.0e-10;
+
+  if (print) {
+    printf("TDHF(GMRES) %s (w=%.4f): ", m_h->name().c_str(), omega);
+    std::cout << std::flush;
+  }
+
+  m_hFcore = form_hFcore();
+
+  // Each unknown dPsi (X, then Y), in same order as pack_dPsi()
+  struct Unknown {
+    dPsiType XorY;
+    std::size_t ib, ibeta;
+  };
+  std::vector<Unknown> unknowns;
+  for (const auto XorY : {dPsiType::X, dPsiType::Y}) {
+    if (XorY == dPsiType::Y && staticQ)
+      break;
+    for (std::size_t ib = 0; ib < m_X.size(); ++ib) {
+      for (std::size_t ibeta = 0; ibeta < m_X[ib].size(); ++ibeta) {
+        unknowns.push_back({XorY, ib, ibeta});
+      }
+    }
+  }
+  const auto num_points = m_core.front().grid().num_points();
+
+  // The equation for each dPsi (as in solveMixedState) is:
+  //   (H_loc + vx - e - w)Z = vx*Z - Vex*Z - Vbr*Z - Q[h + dV(X,Y)]Phi
+  // with X = Q.Z, Q projects out Phi (if same kappa), and vx is a local
+  // approximation to exchange. Preconditioner: P = (H_loc + vx - e - w)^-1;
+  // solutions regular at 0 and infinity (F0, Finf) are stored, so each
+  // application of P is a single Green's-function integral. Then, solve:
+  //   Z - P[vx*Z - Vex*Z - Vbr*Z - Q.dV(QZ)] = -P[Q.h.Phi]
+  struct Precond {
+    std::vector<double> vx;
+    DiracSpinor F0, Finf;
+  };
+  std::vector<Precond> precond;
+  for (const auto &u : unknowns) {
+    const auto &dF = m_X[u.ib][u.ibeta];
+    precond.push_back({{}, 0.0 * dF, 0.0 * dF});
+  }
+  std::vector<double> b(unknowns.size() * 2 * num_points);
+
+  // Common to all: energy, rhs [with projection], and P
+  const auto omega_conj = [&](const Unknown &u) {
+    const auto ww = u.XorY == dPsiType::X ? omega : -omega;
+    auto conj = u.XorY == dPsiType::Y;
+    if (omega < 0.0)
+      conj = !conj;
+    return std::make_pair(ww, conj);
+  };
+  const auto project = [](DiracSpinor &rhs, const DiracSpinor &Fb) {
+    if (rhs.kappa() == Fb.kappa())
+      rhs -= (Fb * rhs) * Fb;
+  };
+  const auto apply_P = [&](std::size_t k, const DiracSpinor &source,
+                           double *out) {
+    auto dF = source;
+    DiracODE::Internal::GreenSolution(dF, precond[k].Finf, precond[k].F0,
+                                      m_alpha, source);
+    std::copy(dF.f().cbegin(), dF.f().cend(), out);
+    std::copy(dF.g().cbegin(), dF.g().cend(), out + num_points);
+  };
+
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t k = 0; k < unknowns.size(); ++k) {
+    const auto &u = unknowns[k];
+    const auto &Fb = m_core[u.ib];
+    const auto kappa = m_X[u.ib][u.ibeta].kappa();
+    const auto [ww, conj] = omega_conj(u);
+    const auto &vl = p_hf->vlocal(Angular::l_k(kappa));
+    const auto &Hmag = p_hf->Hmag(Angular::l_k(kappa));
+
+    auto rhs = (m_imag && conj ? -1.0 : 1.0) * m_hFcore[u.ib][u.ibeta];
+    if (!m_imag)
+      project(rhs, Fb);
+    rhs *= -1.0;
+
+    // vx: from solution with local potential only
+    auto &[vx, F0, Finf] = precond[k];
+    auto dF = DiracODE::solve_inhomog(kappa, Fb.en() + ww, vl, Hmag, m_alpha,
+                                      rhs);
+    vx = HF::vex_approx(dF, m_core);
+    DiracODE::solve_inhomog(dF, F0, Finf, Fb.en() + ww, vl + vx, Hmag,
+                            m_alpha, rhs);
+    apply_P(k, rhs, b.data() + k * 2 * num_points);
+  }
+
+  // (1 - P.K)Z
+  const auto A = [&](const std::vector<double> &z) {
+    // m_X, m_Y: Q.Z, used for dV. Keep Z
+    unpack_dPsi(z, !staticQ);
+    const auto Z_X = m_X;
+    const auto Z_Y = m_Y;
+    for (const auto pdPsi : {&m_X, &m_Y}) {
+      for (std::size_t ib = 0; ib < m_core.size(); ++ib) {
+        for (auto &dF : (*pdPsi)[ib]) {
+          project(dF, m_core[ib]);
+        }
+      }
+    }
+
+    std::vector<double> Az(z.size());
+#pragma omp parallel for schedule(dynamic)
+    for (std::size_t k = 0; k < unknowns.size(); ++k) {
+      const auto &u = unknowns[k];
+      const auto &Fb = m_core[u.ib];
+      const auto &Z = (u.XorY == dPsiType::X ? Z_X : Z_Y)[u.ib][u.ibeta];
+      const auto conj = omega_conj(u).second;
+
+      auto rhs = dV_rhs(Z.kappa(), Fb, conj);
+      if (!m_imag)
+        project(rhs, Fb);
+      auto source = precond[k].vx * Z - HF::vexFa(Z, m_core) - rhs;
+      if (p_VBr)
+        source -= p_VBr->VbrFa(Z, m_core);
+
+      auto *const out = Az.data() + k * 2 * num_points;
+      apply_P(k, source, out);
+      const auto *const zk = z.data() + k * 2 * num_points;
+      for (std::size_t i = 0; i < 2 * num_points; ++i) {
+        out[i] = zk[i] - out[i];
+      }
+    }
+    return Az;
+  };
+
+  auto z = pack_dPsi(!staticQ);
+  const auto [its, rel_res] =
+      LinAlg::GMRES(A, b, z, converge_targ, max_its, restart);
+
+  // Final solution: X = Q.Z
+  unpack_dPsi(z, !staticQ);
+  for (const auto pdPsi : {&m_X, &m_Y}) {
+    for (std::size_t ib = 0; ib < m_core.size(); ++ib) {
+      for (auto &dF : (*pdPsi)[ib]) {
+        project(dF, m_core[ib]);
+      }
+    }
+  }
+  m_core_eps = rel_res * rel_res;
+  m_core_its = its;
+  m_core_omega = omega;
+
+  if (print) {
+    printf("%2i %.1e", its, m_core_eps);
+    if (m_core_eps > 1.0e-6 && max_its > 1)
+      std::cout << "  *";
+    if (m_core_eps > 1.0e-4 && max_its > 1)
+      std::cout << "**";
+    std::cout << "\n" << std::flush;
+  }
+}
+
+//------------------------------------------------------------------------------
+std::vector<double> TDHF::pack_dPsi(bool include_Y) const {
+  std::vector<double> u;
+  for (const auto pdPsi : {&m_X, &m_Y}) {
+    if (pdPsi == &m_Y && !include_Y)
+      break;
+    for (const auto &dFb : *pdPsi) {
+      for (const auto &dF : dFb) {
+        u.insert(u.end(), dF.f().cbegin(), dF.f().cend());
+        u.insert(u.end(), dF.g().cbegin(), dF.g().cend());
+      }
+    }
+  }
+  return u;
+}
+
+//------------------------------------------------------------------------------
+void TDHF::unpack_dPsi(const std::vector<double> &u, bool include_Y) {
+  auto it = u.cbegin();
+  for (const auto pdPsi : {&m_X, &m_Y}) {
+    if (pdPsi == &m_Y && !include_Y)
+      break;
+    for (auto &dFb : *pdPsi) {
+      for (auto &dF : dFb) {
+        const auto num_points = long(dF.f().size());
+        std::copy(it, it + num_points, dF.f().begin());
+        std::copy(it + num_points, it + 2 * num_points, dF.g().begin());
+        it += 2 * num_points;
+        // Krylov vectors are not localised: use full range of non-zeros
+        auto max_pt = dF.f().size();
+        while (max_pt > 0 && dF.f(max_pt - 1) == 0.0 &&
+               dF.g(max_pt - 1) == 0.0) {
+          --max_pt;
+        }
+        dF.min_pt() = 0;
+        dF.max_pt() = max_pt;
+      }
+    }
+  }
+  assert(it == u.cend());
+  if (!include_Y) {
+    using namespace qip::overloads;
+    const auto s = m_imag ? -1.0 : 1.0;
+    for (std::size_t ib = 0; ib < m_X.size(); ++ib) {
+      m_Y[ib] = s * m_X[ib];
+    }
+  }
+}
+
+//==============================================================================
+void TDHF::extrapolate(const std::vector<std::vector<DiracSpinor>> &X_prev,
+                       const std::vector<std::vector<DiracSpinor>> &Y_prev,
+                       double t) {
+  for (std::size_t ib = 0; ib < m_X.size(); ++ib) {
+    for (std::size_t ibeta = 0; ibeta < m_X[ib].size(); ++ibeta) {
+      // (1+t)*dPsi - t*dPsi_prev
+      m_X[ib][ibeta] *= 1.0 + t;
+      m_X[ib][ibeta].add(-t, X_prev[ib][ibeta]);
+      m_Y[ib][ibeta] *= 1.0 + t;
+      m_Y[ib][ibeta].add(-t, Y_prev[ib][ibeta]);
+    }
+  }
+}
+
+//==============================================================================
+void TDHF::solve_sweep(const std::vector<double> &omegas,
+                       const SweepFunction &f, int max_its, const bool print) {
+  if (omegas.empty())
+    return;
+
+  // First point of each chunk is not (well) warm-started, so is expensive.
+  // Keep chunks >~8 points; otherwise better to parallelise within solve
+  const auto num_points = omegas.size();
+  const auto num_chunks = std::clamp(num_points / 8, std::size_t{1},
+                                     std::size_t(omp_get_max_threads()));
+
+  // private copy for each chunk; each starts from current solution
+  std::vector<TDHF> tdhfs(num_chunks, *this);
+  std::vector<int> its(num_points);
+  std::vector<double> epss(num_points);
+
+#pragma omp parallel for schedule(static, 1)
+  for (std::size_t ic = 0; ic < num_chunks; ++ic) {
+    auto &tdhf = tdhfs[ic];
+    const auto i_begin = ic * num_points / num_chunks;
+    const auto i_end = (ic + 1) * num_points / num_chunks;
+    // Solution at omegas[i-2] (for extrapolation)
+    std::vector<std::vector<DiracSpinor>> X_prev, Y_prev;
+    for (auto i = i_begin; i < i_end; ++i) {
+      const auto w = omegas[i];
+      const bool warm = i > i_begin;
+      auto X_i1 = tdhf.m_X;
+      auto Y_i1 = tdhf.m_Y;
+      if (i > i_begin + 1 && omegas[i - 1] != omegas[i - 2]) {
+        const auto t = (w - omegas[i - 1]) / (omegas[i - 1] - omegas[i - 2]);
+        tdhf.extrapolate(X_prev, Y_prev, t);
+      }
+      tdhf.solve_core_impl(w, max_its, false, warm ? 1 : 6);
+      its[i] = tdhf.m_core_its;
+      if (warm && tdhf.m_core_eps > 1.0e-2) {
+        // if tdhf didn't converge well, start from scratch
+        tdhf.clear();
+        tdhf.solve_core_impl(w, max_its, false, 6);
+        its[i] += tdhf.m_core_its;
+      }
+      epss[i] = tdhf.m_core_eps;
+      X_prev = std::move(X_i1);
+      Y_prev = std::move(Y_i1);
+      f(tdhf, i);
+    }
+  }
+
+  // *this keeps solution for final frequency
+  auto &last = tdhfs.back();
+  m_X = std::move(last.m_X);
+  m_Y = std::move(last.m_Y);
+  m_hFcore = std::move(last.m_hFcore);
+  m_core_eps = last.m_core_eps;
+  m_core_its = last.m_core_its;
+  m_core_omega = last.m_core_omega;
+
+  if (print) {
+    const auto tot_its = std::accumulate(its.cbegin(), its.cend(), 0);
+    printf("TDHF %s sweep (w=%.4f-%.4f; %zu points, %zu threads): %i its, "
+           "worst eps=%.1e\n",
+           m_h->name().c_str(), omegas.front(), omegas.back(), num_points,
+           num_chunks, tot_its, *std::max_element(epss.cbegin(), epss.cend()));
+    std::cout << std::flush;
+  }
+}
+
 //==============================================================================
 // does it matter if a or b is in the core?
 double TDHF::dV(const DiracSpinor &Fn, const DiracSpinor &Fm, bool conj) const {
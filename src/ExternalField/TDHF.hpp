@@ -70,6 +70,37 @@ public:
   virtual void solve_core(const double omega, int max_its = 100,
                           const bool print = true) override;
 
+  //! Solves TDHF equations for core electrons as a single linear system,
+  //! using (restarted) GMRES. Alternative to solve_core().
+  /*! @details The TDHF equations are linear in the set of all {X,Y}. Rather
+  than iterating them (and, for each orbital, the mixed-states equation, as in
+  solveMixedState), the combined system is solved directly by GMRES. The
+  preconditioner is the single-orbital local-potential inverse, (H_loc + vx -
+  e -+ w)^-1, as used by solveMixedState (vx: local approximation to
+  exchange). Each iteration costs one dV and one inhomogeneous solve for each
+  dPsi (i.e., similar to a single solveMixedState iteration), and no damping
+  is required. Krylov basis of up to 50 vectors is stored. Starts from the
+  current dPsi (e.g., a previous solve). max_its is the maximum number of
+  Krylov iterations. get_eps() returns the squared relative residual
+  (comparable to solve_core()).
+  */
+  void solve_core_krylov(const double omega, int max_its = 100,
+                         const bool print = true);
+
+  //! Solves TDHF equations for each frequency in omegas, calling f(tdhf, i)
+  //! for each. See CorePolarisation::solve_sweep.
+  /*! @details The frequency grid is split into contiguous chunks, which are
+  solved in parallel, each by a private copy of *this (f is called from
+  several threads; the passed CorePolarisation is always a TDHF). Each chunk
+  begins from the current solution; every following point begins from a
+  linear extrapolation of the previous two, and typically converges in a few
+  iterations. If a warm-started solve fails (e.g., near a resonance), it is
+  re-started from scratch.
+  */
+  virtual void solve_sweep(const std::vector<double> &omegas,
+                           const SweepFunction &f, int max_its = 100,
+                           const bool print = false) override;
+
   //! Returns RPA method
   virtual Method method() const override { return Method::TDHF; }
 
@@ -127,6 +158,17 @@ public:
 private:
   void initialise_dPsi();
 
+  // Solves TDHF eqs, with at least min_its iterations
+  void solve_core_impl(double omega, int max_its, bool print, int min_its);
+  // All dPsi (X, then Y if include_Y) as single vector (f and g, full grid)
+  std::vector<double> pack_dPsi(bool include_Y) const;
+  // Inverse of pack_dPsi. If !include_Y, Y = +/- X (static case)
+  void unpack_dPsi(const std::vector<double> &u, bool include_Y);
+  // Linear extrapolation in frequency: dPsi -> dPsi + t*(dPsi - dPsi_prev)
+  void extrapolate(const std::vector<std::vector<DiracSpinor>> &X_prev,
+                   const std::vector<std::vector<DiracSpinor>> &Y_prev,
+                   double t);
+
   // Single iteration of TDHF equations
   std::pair<double, std::string> tdhf_core_it(double omega, double eta_damp);
   // Forms set of h*Fc for all core orbitals and all projections
@@ -6,6 +6,7 @@
 #include "fmt/format.hpp"
 #include "qip/Vector.hpp"
 #include <algorithm>
+#include <numeric>
 #include <string>
 
 //==============================================================================
@@ -63,6 +64,99 @@ TEST_CASE("External Field: TDHF - basic unit tests",
   REQUIRE(dv_00 == 0.0);
 }
 
+//==============================================================================
+TEST_CASE("External Field: TDHF - frequency sweep",
+          "[ExternalField][TDHF][RPA][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "External Field: TDHF - frequency sweep\n";
+
+  Wavefunction wf({800, 1.0e-4, 100.0, 20.0, "loglinear", -1.0},
+                  {"Cs", -1, "Fermi", -1.0, -1.0}, 1.0);
+  wf.solve_core("HartreeFock", 0.0, "[Xe]");
+  wf.solve_valence("6sp");
+  const auto &F6s = *wf.getState("6s");
+  const auto &F6p = *wf.getState("6p-");
+
+  auto dE1 = DiracOperator::E1(wf.grid());
+
+  const auto omegas = qip::uniform_range(0.0, 0.04, 9);
+
+  // Solve each frequency from scratch
+  std::vector<double> dv_scratch;
+  int its_scratch = 0;
+  for (const auto w : omegas) {
+    auto rpa = ExternalField::TDHF(&dE1, wf.vHF());
+    rpa.solve_core(w, 100, false);
+    its_scratch += int(rpa.get_its());
+    dv_scratch.push_back(rpa.dV(F6s, F6p));
+  }
+
+  // Sweep: each solve starts from neighbour
+  auto rpa = ExternalField::TDHF(&dE1, wf.vHF());
+  rpa.solve_core(omegas.front(), 100, false);
+  std::vector<double> dv_sweep(omegas.size());
+  std::vector<double> w_sweep(omegas.size());
+  std::vector<int> its_sweep(omegas.size());
+  // nb: may be called from several threads at once
+  rpa.solve_sweep(omegas, [&](const auto &dV, std::size_t i) {
+    w_sweep.at(i) = dV.get_omega();
+    its_sweep.at(i) = int(dV.get_its());
+    dv_sweep.at(i) = dV.dV(F6s, F6p);
+  });
+  const auto tot_its_sweep =
+      std::accumulate(its_sweep.cbegin(), its_sweep.cend(), 0);
+  std::cout << "Total its: " << its_scratch << " (scratch), " << tot_its_sweep
+            << " (sweep)\n";
+
+  REQUIRE(w_sweep == omegas);
+  // nb: TDHF convergence (eps~1e-9 for |dPsi|^2) is ~1e-5 for dV
+  for (std::size_t i = 0; i < omegas.size(); ++i) {
+    REQUIRE(dv_sweep.at(i) == Approx(dv_scratch.at(i)).epsilon(1.0e-4));
+  }
+  REQUIRE(tot_its_sweep < its_scratch / 2);
+  // *this holds final solution
+  REQUIRE(rpa.get_omega() == omegas.back());
+  REQUIRE(rpa.dV(F6s, F6p) == Approx(dv_sweep.back()));
+}
+
+//==============================================================================
+TEST_CASE("External Field: TDHF - Krylov solver",
+          "[ExternalField][TDHF][RPA][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "External Field: TDHF - Krylov solver\n";
+
+  Wavefunction wf({2000, 1.0e-6, 100.0, 20.0, "loglinear", -1.0},
+                  {"Cs", -1, "Fermi", -1.0, -1.0}, 1.0);
+  wf.solve_core("HartreeFock", 0.0, "[Xe]");
+  wf.solve_valence("6sp5d");
+
+  auto dE1 = DiracOperator::E1(wf.grid());
+  auto dE2 = DiracOperator::Ek(wf.grid(), 2);
+
+  for (const auto h :
+       std::vector<DiracOperator::TensorOperator *>{&dE1, &dE2}) {
+    const auto &Fa = *wf.getState(h == &dE1 ? "6p-" : "5d-");
+    const auto &Fb = *wf.getState("6s");
+    for (const auto w : {0.0, 0.05}) {
+      auto rpa_fp = ExternalField::TDHF(h, wf.vHF());
+      rpa_fp.solve_core(w);
+      auto rpa_gm = ExternalField::TDHF(h, wf.vHF());
+      rpa_gm.solve_core_krylov(w);
+      REQUIRE(rpa_gm.get_eps() < 1.0e-9);
+      REQUIRE(rpa_gm.get_omega() == w);
+      // Same equations, solved differently: agree to level of radial
+      // discretisation (~1e-5 for E1, but ~5e-4 for E2 at w!=0 on this grid)
+      REQUIRE(rpa_gm.dV(Fa, Fb) == Approx(rpa_fp.dV(Fa, Fb)).epsilon(1.0e-3));
+      REQUIRE(rpa_gm.dV(Fb, Fa) == Approx(rpa_fp.dV(Fb, Fa)).epsilon(1.0e-3));
+
+      // Starting from solution: few iterations
+      const auto its_0 = rpa_gm.get_its();
+      rpa_gm.solve_core_krylov(w);
+      REQUIRE(rpa_gm.get_its() < 0.5 * its_0);
+    }
+  }
+}
+
 //==============================================================================
 struct TestData {
   std::string a, b;
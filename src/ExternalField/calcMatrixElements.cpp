@@ -7,7 +7,10 @@
 #include "TDHFbasis.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
 #include "fmt/color.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -20,53 +23,24 @@ std::vector<MEdata> calcMatrixElements(const std::vector<DiracSpinor> &b_orbs,
                                        bool each_freq, bool diagonal,
                                        bool off_diagonal, bool calculate_both) {
 
-  std::vector<MEdata> res;
-
   const auto pi = h->parity();
 
   if (&b_orbs != &a_orbs)
     calculate_both = true;
 
-  if (h->freqDependantQ() && !each_freq) {
-    h->updateFrequency(omega);
-  }
-
-  if (dV && !each_freq) {
-    dV->solve_core(omega);
-  }
-
-  // First, diagonal:
+  // 1. List all required {a,b} pairs, in output order (diagonal first)
+  std::vector<std::pair<const DiracSpinor *, const DiracSpinor *>> pairs;
   if (diagonal) {
-
-    if (each_freq && h->freqDependantQ()) {
-      h->updateFrequency(0.0);
-    }
-    if (each_freq && dV) {
-      if (dV->get_eps() > 1.0e-5)
-        dV->clear();
-      dV->solve_core(0.0);
-    }
-
-    for (std::size_t ia = 0; ia < a_orbs.size(); ia++) {
-      const auto &Fa = b_orbs.at(ia);
-
-      if (h->isZero(Fa.kappa(), Fa.kappa()))
-        continue;
-
-      const auto hab = h->reducedME(Fa, Fa);
-      const auto dv = dV ? dV->dV(Fa, Fa) : 0.0;
-
-      const auto w = 0.0;
-      res.emplace_back(MEdata{Fa.shortSymbol(), Fa.shortSymbol(), w, hab, dv});
+    for (const auto &Fa : a_orbs) {
+      if (!h->isZero(Fa.kappa(), Fa.kappa()))
+        pairs.emplace_back(&Fa, &Fa);
     }
   }
-
-  // Then, off-diagonal:
   if (off_diagonal) {
     for (std::size_t ib = 0; ib < b_orbs.size(); ib++) {
       const auto &Fb = b_orbs.at(ib);
       for (std::size_t ia = 0; ia < a_orbs.size(); ia++) {
-        const auto &Fa = b_orbs.at(ia);
+        const auto &Fa = a_orbs.at(ia);
 
         if (Fa == Fb)
           continue;
@@ -81,30 +55,71 @@ std::vector<MEdata> calcMatrixElements(const std::vector<DiracSpinor> &b_orbs,
           if (!calculate_both && ib > ia)
             continue;
         }
+        pairs.emplace_back(&Fa, &Fb);
+      }
+    }
+  }
 
-        const auto ww = std::abs(Fa.en() - Fb.en());
-        if (each_freq && h->freqDependantQ()) {
-          h->updateFrequency(ww);
-        }
-        if (each_freq && dV) {
-          if (dV->get_eps() > 1.0e-5)
-            dV->clear();
-          dV->solve_core(ww);
-        }
-
-        const auto hab = h->reducedME(Fa, Fb);
-        const auto dv = dV ? dV->dV(Fa, Fb) : 0.0;
+  // 2. Group pairs by transition frequency, so the RPA (and frequency-
+  // dependent operator) need only be solved once per distinct frequency.
+  // Groups are solved in order of increasing frequency; each RPA solution is
+  // then a good starting point for the next.
+  const auto freq = [&](std::size_t i) {
+    return each_freq ? std::abs(pairs[i].first->en() - pairs[i].second->en()) :
+                       omega;
+  };
+  std::vector<std::size_t> order(pairs.size());
+  std::iota(order.begin(), order.end(), 0ul);
+  std::stable_sort(order.begin(), order.end(), [&](auto i, auto j) {
+    return freq(i) < freq(j);
+  });
+
+  // 3. Solve once per group, then evaluate the group's MEs in parallel
+  std::vector<MEdata> res(pairs.size());
+  const double eps_w = 1.0e-10; // frequencies this close are 'equal'
+  for (auto first = order.begin(); first != order.end();) {
+    const auto ww = freq(*first);
+    const auto last = std::find_if(first, order.end(), [&](auto i) {
+      return freq(i) > ww + eps_w;
+    });
+
+    if (h->freqDependantQ()) {
+      h->updateFrequency(ww);
+    }
+    if (dV) {
+      if (each_freq && dV->get_eps() > 1.0e-5)
+        dV->clear();
+      dV->solve_core(ww);
+    }
 
-        const auto w = Fa.en() - Fb.en();
-        res.emplace_back(
-            MEdata{Fa.shortSymbol(), Fb.shortSymbol(), w, hab, dv});
-      }
+    const auto group = std::vector<std::size_t>(first, last);
+#pragma omp parallel for
+    for (std::size_t ig = 0; ig < group.size(); ++ig) {
+      const auto i = group[ig];
+      const auto &Fa = *pairs[i].first;
+      const auto &Fb = *pairs[i].second;
+      const auto hab = h->reducedME(Fa, Fb);
+      const auto dv = dV ? dV->dV(Fa, Fb) : 0.0;
+      const auto w = Fa.en() - Fb.en();
+      res[i] = MEdata{Fa.shortSymbol(), Fb.shortSymbol(), w, hab, dv};
     }
+    first = last;
   }
 
   return res;
 }
 
+//==============================================================================
+void write_table(std::ostream &os, const std::vector<MEdata> &mes,
+                 const std::string &label) {
+  const auto name = label.empty() ? std::string{"h"} : label;
+  os << "# operator a b w_ab t_ab dv_ab t_ab+dv_ab\n";
+  for (const auto &[a, b, w, hab, dv] : mes) {
+    os << qip::fstring("%s %s %s %.10e %.10e %.10e %.10e\n", name.c_str(),
+                       a.c_str(), b.c_str(), w, hab, dv, hab + dv);
+  }
+}
+
 //==============================================================================
 // Required to set omega for freq. dependent operators initially
 Coulomb::meTable<double> me_table(const std::vector<DiracSpinor> &a_orbs,
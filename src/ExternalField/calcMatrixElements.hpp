@@ -29,9 +29,9 @@ w_wb: frequency: Ea-Eb
 */
 struct MEdata {
 
-  std::string a, b;
-  double w_ab;
-  double hab, dv;
+  std::string a{}, b{};
+  double w_ab{0.0};
+  double hab{0.0}, dv{0.0};
 
   static std::string title(bool rpaQ = true) {
     if (rpaQ)
@@ -51,6 +51,15 @@ struct MEdata {
   }
 };
 
+//! Calculates reduced matrix elements <a||h+dV||b>.
+/*!
+@details
+If each_freq is true, RPA (dV) and frequency-dependent operators are evaluated
+at each transition frequency |Ea-Eb|; otherwise, at omega. Pairs are grouped by
+frequency: dV is solved once per distinct frequency, and the matrix elements
+within each group are evaluated in parallel. Output order is independent of
+the grouping: diagonal first, then off-diagonal.
+*/
 std::vector<MEdata>
 calcMatrixElements(const std::vector<DiracSpinor> &b_orbs,
                    const std::vector<DiracSpinor> &a_orbs,
@@ -69,6 +78,11 @@ calcMatrixElements(const std::vector<DiracSpinor> &orbs,
                             off_diagonal, calculate_both);
 }
 
+//! Writes matrix elements as a plain-text table, one whitespace-separated row
+//! per pair (label, a, b, w_ab, t_ab, dv_ab, t_ab+dv_ab); header begins '#'
+void write_table(std::ostream &os, const std::vector<MEdata> &mes,
+                 const std::string &label = "");
+
 //! Fills me_table with MEs, <a||h||b> and <b||h||a>.
 //! Required to set omega for freq. dependent operators initially
 Coulomb::meTable<double> me_table(const std::vector<DiracSpinor> &a_orbs,
@@ -3,7 +3,10 @@
 #include "TDHF.hpp"
 #include "Wavefunction/DiracSpinor.hpp"
 #include "catch2/catch.hpp"
+#include <cmath>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 TEST_CASE("External Field: calcMatrixElements", "[ExternalField][unit]") {
@@ -38,4 +41,34 @@ TEST_CASE("External Field: calcMatrixElements", "[ExternalField][unit]") {
     auto hdv0 = rpa.dV(*Fa, *Fb);
     REQUIRE(dv == Approx(hdv0));
   }
-}
\ No newline at end of file
+
+  // Each frequency: RPA solved once per distinct |w_ab|
+  const auto mes_w =
+      ExternalField::calcMatrixElements(wf.valence(), &dE1, &rpa, 0.0, true);
+  REQUIRE(mes_w.size() == mes.size());
+  for (std::size_t i = 0; i < mes.size(); ++i) {
+    // output order does not depend on the frequency grouping
+    REQUIRE(mes_w[i].a == mes[i].a);
+    REQUIRE(mes_w[i].b == mes[i].b);
+  }
+  for (auto &me : mes_w) {
+    auto Fa = wf.getState(me.a);
+    auto Fb = wf.getState(me.b);
+    auto rpa_w = ExternalField::TDHF(&dE1, wf.vHF());
+    rpa_w.solve_core(std::abs(me.w_ab));
+    REQUIRE(me.dv == Approx(rpa_w.dV(*Fa, *Fb)).epsilon(1.0e-4));
+  }
+
+  // Plain-text table: header + one row per ME
+  std::stringstream table;
+  ExternalField::write_table(table, mes_w, "E1");
+  std::string line;
+  std::size_t num_rows = 0;
+  while (std::getline(table, line)) {
+    if (line.front() != '#') {
+      REQUIRE(line.substr(0, 3) == "E1 ");
+      ++num_rows;
+    }
+  }
+  REQUIRE(num_rows == mes_w.size());
+}
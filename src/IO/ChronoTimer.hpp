@@ -1,7 +1,9 @@
 #pragma once
+#include "IO/Profile.hpp"
 #include <chrono>
 #include <iomanip> // setprecision
 #include <iostream>
+#include <optional>
 #include <sstream> // stringstream
 #include <string>
 
@@ -31,6 +33,9 @@ be (e.g., to not time a certain part of the code)
   - reading_str() and lap_reading_str() -- As above, but outputs as formatted
 string, in units of ms,s,mins, or hours (e.g., "1.56 s" or "2.10 hours")
 
+A named timer is also an IO::Profile::Region (for its whole lifetime), so
+timed stages appear in the profile summary when profiling is enabled.
+
 */
 class ChronoTimer {
 public:
@@ -48,6 +53,7 @@ public:
 
 private:
   std::string name;
+  std::optional<Profile::Region> region{};
   bool running;
   std::chrono::high_resolution_clock::time_point tstart{};
   std::string convertHR(double t) const;
@@ -57,6 +63,9 @@ private:
 //==============================================================================
 inline ChronoTimer::ChronoTimer(std::string_view in_name)
     : name(in_name), running(false), total_time_ms(0) {
+  const auto pos = in_name.find_first_not_of(" \n");
+  if (pos != std::string_view::npos)
+    region.emplace(in_name.substr(pos));
   start();
 }
 //==============================================================================
@@ -0,0 +1,353 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace IO {
+
+/*!
+@brief Lightweight, hierarchical, thread-aware profiling.
+@details
+Mark a region of code by constructing a Region; it is timed until the Region
+goes out of scope. Regions nest: each region is stored as a child of the region
+(on the same thread) that was active when it started, and the time and number
+of calls are accumulated per thread. Regions started on other (e.g., OpenMP)
+threads, outside any region on that thread, are placed under whichever region
+was active on the main thread at that time.
+
+Named IO::ChronoTimers also open a Region (so every timed stage is profiled).
+
+Profiling is off by default; when off, a Region costs a single (relaxed)
+atomic load. Turn on with enable() (ampsci does this if the Profile{} input
+block is given). At the end, print_summary() prints the tree of regions, and
+write_trace() writes a Chrome-trace JSON file (open with chrome://tracing or
+https://ui.perfetto.dev).
+
+Usage:
+@code{.cpp}
+  IO::Profile::enable(true);
+  {
+    IO::Profile::Region r("HF core");
+    ...
+  }
+  IO::Profile::print_summary(std::cout);
+  IO::Profile::write_trace("ampsci_trace.json");
+@endcode
+
+Note: Regions must be strictly nested on each thread (i.e., scope based).
+print_summary/write_trace/clear must be called while no regions are active.
+*/
+namespace Profile {
+
+namespace detail {
+using Clock = std::chrono::steady_clock;
+
+struct Node {
+  std::string name;
+  int parent;         // index in same thread's nodes; -1 for top-level
+  int main_parent;    // top-level nodes on other threads: main-thread node
+  std::int64_t ns{0}; // total time, in ns
+  std::uint64_t count{0};
+  std::vector<int> children{};
+};
+
+struct Event {
+  int node;
+  std::int64_t start_ns;
+  std::int64_t dur_ns;
+};
+
+struct ThreadData {
+  int tid{0};
+  bool is_main{false};
+  std::vector<Node> nodes{};
+  std::vector<int> top{}; // top-level nodes
+  std::vector<int> stack{};
+  std::vector<Event> events{};
+
+  // Returns index of child (of parent) with given name; adds if new
+  int child(int parent, std::string_view name, int main_parent) {
+    auto &list = parent < 0 ? top : nodes[std::size_t(parent)].children;
+    for (const auto i : list) {
+      const auto &node = nodes[std::size_t(i)];
+      if (node.main_parent == main_parent && node.name == name)
+        return i;
+    }
+    const auto index = int(nodes.size());
+    nodes.push_back({std::string(name), parent, main_parent, 0, 0, {}});
+    // nb: 'list' may be invalidated by push_back
+    (parent < 0 ? top : nodes[std::size_t(parent)].children).push_back(index);
+    return index;
+  }
+};
+
+struct State {
+  std::mutex mutex{};
+  std::vector<std::unique_ptr<ThreadData>> threads{};
+  std::thread::id main_thread{};
+  Clock::time_point epoch{Clock::now()};
+  std::atomic<int> main_current{-1};
+  std::size_t max_events{0};
+};
+
+// Checked by every Region: keep separate from the rest of the state
+inline std::atomic<bool> g_enabled{false};
+
+inline State &state() {
+  static State s;
+  return s;
+}
+
+// Data for the calling thread (created, and registered, on first use)
+inline ThreadData &thread_data() {
+  thread_local ThreadData *td = nullptr;
+  if (td == nullptr) {
+    auto &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto &new_td = s.threads.emplace_back(std::make_unique<ThreadData>());
+    new_td->tid = int(s.threads.size()) - 1;
+    new_td->is_main = std::this_thread::get_id() == s.main_thread;
+    td = new_td.get();
+  }
+  return *td;
+}
+} // namespace detail
+
+//==============================================================================
+//! Turns profiling on/off. The calling thread is taken as the 'main' thread.
+//! If max_trace_events>0, also stores up to this many events per thread
+//! for write_trace(). Call before any parallel region.
+inline void enable(bool on, std::size_t max_trace_events = 0) {
+  auto &s = detail::state();
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.main_thread = std::this_thread::get_id();
+    s.max_events = max_trace_events;
+    for (auto &td : s.threads)
+      td->is_main = false;
+  }
+  detail::thread_data().is_main = true;
+  detail::g_enabled.store(on, std::memory_order_relaxed);
+}
+
+//! True if profiling is on
+inline bool enabled() {
+  return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+//! Profiled region of code: timed from construction until end of scope
+class Region {
+  detail::ThreadData *m_td{nullptr};
+  int m_node{-1};
+  int m_prev_main{-1};
+  detail::Clock::time_point m_start{};
+
+public:
+  explicit Region(std::string_view name) {
+    if (enabled())
+      begin(name);
+  }
+  ~Region() {
+    if (m_td != nullptr)
+      end();
+  }
+  Region(const Region &) = delete;
+  Region &operator=(const Region &) = delete;
+
+private:
+  void begin(std::string_view name) {
+    auto &s = detail::state();
+    m_td = &detail::thread_data();
+    const auto parent = m_td->stack.empty() ? -1 : m_td->stack.back();
+    const auto main_parent =
+        (parent < 0 && !m_td->is_main) ?
+            s.main_current.load(std::memory_order_relaxed) :
+            -1;
+    m_node = m_td->child(parent, name, main_parent);
+    m_td->stack.push_back(m_node);
+    if (m_td->is_main)
+      m_prev_main = s.main_current.exchange(m_node, std::memory_order_relaxed);
+    m_start = detail::Clock::now();
+  }
+
+  void end() {
+    const auto t_end = detail::Clock::now();
+    auto &s = detail::state();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        t_end - m_start)
+                        .count();
+    auto &node = m_td->nodes[std::size_t(m_node)];
+    node.ns += ns;
+    ++node.count;
+    m_td->stack.pop_back();
+    if (m_td->is_main)
+      s.main_current.store(m_prev_main, std::memory_order_relaxed);
+    if (m_td->events.size() < s.max_events) {
+      const auto start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             m_start - s.epoch)
+                             .count();
+      m_td->events.push_back({m_node, start, ns});
+    }
+  }
+};
+
+//==============================================================================
+namespace detail {
+// Regions from all threads, merged by position in tree
+struct Merged {
+  std::string name{};
+  std::int64_t ns_sum{0};
+  std::uint64_t count{0};
+  std::map<int, std::int64_t> ns_thread{}; // tid -> time
+  std::vector<std::unique_ptr<Merged>> children{};
+
+  Merged *child(const std::string &in_name) {
+    for (auto &c : children)
+      if (c->name == in_name)
+        return c.get();
+    children.push_back(std::make_unique<Merged>());
+    children.back()->name = in_name;
+    return children.back().get();
+  }
+};
+
+inline void merge_node(Merged *out, const ThreadData &td, int i,
+                       std::map<int, Merged *> *main_map) {
+  const auto &node = td.nodes[std::size_t(i)];
+  out->ns_sum += node.ns;
+  out->count += node.count;
+  out->ns_thread[td.tid] += node.ns;
+  if (main_map)
+    (*main_map)[i] = out;
+  for (const auto c : node.children)
+    merge_node(out->child(td.nodes[std::size_t(c)].name), td, c, main_map);
+}
+
+inline Merged merge_all() {
+  auto &s = state();
+  Merged root;
+  std::map<int, Merged *> main_map; // main-thread node -> merged node
+  // main thread first, so other threads can be attached to its regions
+  for (const auto &td : s.threads) {
+    if (!td->is_main)
+      continue;
+    for (const auto i : td->top)
+      merge_node(root.child(td->nodes[std::size_t(i)].name), *td, i,
+                 &main_map);
+  }
+  for (const auto &td : s.threads) {
+    if (td->is_main)
+      continue;
+    for (const auto i : td->top) {
+      const auto &node = td->nodes[std::size_t(i)];
+      const auto it = main_map.find(node.main_parent);
+      auto *parent = it == main_map.end() ? &root : it->second;
+      merge_node(parent->child(node.name), *td, i, nullptr);
+    }
+  }
+  return root;
+}
+
+inline void print_merged(std::ostream &os, const Merged &m, int depth,
+                         std::int64_t parent_ns) {
+  std::int64_t ns_max = 0;
+  for (const auto &[tid, ns] : m.ns_thread)
+    ns_max = std::max(ns_max, ns);
+  const auto name = std::string(std::size_t(2 * depth), ' ') + m.name;
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer),
+                "%-40.40s %9llu %4zu %11.3f %11.3f %6.1f\n", name.c_str(),
+                static_cast<unsigned long long>(m.count), m.ns_thread.size(),
+                double(ns_max) * 1.0e-9, double(m.ns_sum) * 1.0e-9,
+                parent_ns > 0 ? 100.0 * double(ns_max) / double(parent_ns) :
+                                100.0);
+  os << buffer;
+  for (const auto &c : m.children)
+    print_merged(os, *c, depth + 1, ns_max);
+}
+
+// JSON string escaping (names are usually plain)
+inline std::string json_escape(const std::string &in) {
+  std::string out;
+  for (const auto c : in) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      out += c;
+    }
+  }
+  return out;
+}
+} // namespace detail
+
+//==============================================================================
+//! Prints tree of all profiled regions (merged over threads). 'time' is the
+//! largest time on any one thread (~wall time), 'sum' is summed over threads,
+//! and '%' is time as percentage of parent's time.
+inline void print_summary(std::ostream &os) {
+  const auto root = detail::merge_all();
+  os << "\nProfile:\n";
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer), "%-40s %9s %4s %11s %11s %6s\n",
+                "region", "calls", "thr", "time/s", "sum/s", "%");
+  os << buffer;
+  for (const auto &c : root.children)
+    detail::print_merged(os, *c, 0, 0);
+}
+
+//! Writes stored events (see enable()) to file, in Chrome-trace JSON format
+inline void write_trace(const std::string &fname) {
+  auto &s = detail::state();
+  std::ofstream of(fname);
+  if (!of) {
+    std::cout << "\nWARNING 241 in IO::Profile: could not write " << fname
+              << "\n";
+    return;
+  }
+  of << "{\"traceEvents\":[\n";
+  bool first = true;
+  for (const auto &td : s.threads) {
+    for (const auto &[node, start_ns, dur_ns] : td->events) {
+      of << (first ? "" : ",\n") << "{\"name\":\""
+         << detail::json_escape(td->nodes[std::size_t(node)].name)
+         << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << td->tid
+         << ",\"ts\":" << double(start_ns) * 1.0e-3
+         << ",\"dur\":" << double(dur_ns) * 1.0e-3 << "}";
+      first = false;
+    }
+  }
+  of << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//! Clears all profile data (but not the enabled state)
+inline void clear() {
+  auto &s = detail::state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  for (auto &td : s.threads) {
+    td->nodes.clear();
+    td->top.clear();
+    td->stack.clear();
+    td->events.clear();
+  }
+  s.main_current = -1;
+  s.epoch = detail::Clock::now();
+}
+
+} // namespace Profile
+
+} // namespace IO
@@ -0,0 +1,84 @@
+#include "IO/Profile.hpp"
+#include "catch2/catch.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+//==============================================================================
+TEST_CASE("IO: Profile", "[IO][unit]") {
+
+  using namespace IO::Profile;
+
+  // Disabled: nothing is recorded
+  enable(false);
+  clear();
+  { Region r("not recorded"); }
+  REQUIRE(detail::merge_all().children.empty());
+
+  const std::string fname = "deleteme_profile_trace.json";
+  std::remove(fname.c_str());
+
+  enable(true, 100);
+  clear();
+  {
+    Region outer("outer");
+    for (int i = 0; i < 3; ++i) {
+      Region inner("inner");
+    }
+    {
+      Region other("other");
+      Region nested("nested");
+    }
+#pragma omp parallel for
+    for (int i = 0; i < 8; ++i) {
+      Region work("work");
+    }
+  }
+  { Region outer("outer"); }
+  enable(false);
+
+  const auto root = detail::merge_all();
+  REQUIRE(root.children.size() == 1);
+  const auto &outer = *root.children.front();
+  REQUIRE(outer.name == "outer");
+  REQUIRE(outer.count == 2);
+
+  const auto find = [](const detail::Merged &m, const std::string &name) {
+    for (const auto &c : m.children)
+      if (c->name == name)
+        return c.get();
+    return static_cast<detail::Merged *>(nullptr);
+  };
+  const auto inner = find(outer, "inner");
+  REQUIRE(inner != nullptr);
+  REQUIRE(inner->count == 3);
+  REQUIRE(inner->children.empty());
+
+  const auto other = find(outer, "other");
+  REQUIRE(other != nullptr);
+  const auto nested = find(*other, "nested");
+  REQUIRE(nested != nullptr);
+  REQUIRE(nested->count == 1);
+
+  // Regions on OpenMP worker threads are placed under main-thread region
+  const auto work = find(outer, "work");
+  REQUIRE(work != nullptr);
+  REQUIRE(work->count == 8);
+  REQUIRE(root.children.size() == 1);
+
+  // Child time cannot exceed parent time (on the same thread)
+  REQUIRE(inner->ns_sum <= outer.ns_sum);
+
+  std::ostringstream summary;
+  print_summary(summary);
+  REQUIRE(summary.str().find("outer") != std::string::npos);
+  REQUIRE(summary.str().find("  nested") != std::string::npos);
+
+  write_trace(fname);
+  REQUIRE(std::filesystem::exists(fname));
+  REQUIRE(std::filesystem::file_size(fname) > 0);
+  std::remove(fname.c_str());
+
+  clear();
+}
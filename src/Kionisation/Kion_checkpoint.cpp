@@ -0,0 +1,149 @@
+#include "Kion_checkpoint.hpp"
+#include "IO/FRW_fileReadWrite.hpp"
+#include "Maths/Grid.hpp"
+#include "Wavefunction/DiracSpinor.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace Kion {
+
+//==============================================================================
+std::vector<WorkUnit> make_work_units(const std::vector<DiracSpinor> &core,
+                                      const Grid &Egrid,
+                                      std::size_t E_chunk) {
+  const auto num_E = Egrid.num_points();
+  if (E_chunk == 0 || E_chunk > num_E)
+    E_chunk = num_E;
+  std::vector<WorkUnit> units;
+  for (const auto &Fnk : core) {
+    // Only accessible states (same condition as in Module::Kionisation)
+    if (std::abs(Fnk.en()) >= Egrid.back())
+      continue;
+    // Skip energy chunks entirely below the threshold for this shell
+    for (std::size_t i0 = 0; i0 < num_E; i0 += E_chunk) {
+      const auto i1 = std::min(i0 + E_chunk, num_E);
+      if (Egrid(i1 - 1) <= -Fnk.en())
+        continue;
+      units.push_back({Fnk.n(), Fnk.kappa(), i0, i1});
+    }
+  }
+  return units;
+}
+
+//==============================================================================
+PartialResults::PartialResults(std::string fname, std::string identity,
+                               std::size_t num_q)
+    : m_fname(std::move(fname)),
+      m_identity(std::move(identity)),
+      m_num_q(num_q) {}
+
+//------------------------------------------------------------------------------
+std::size_t PartialResults::read(const std::string &fname) {
+  if (!IO::FRW::file_exists(fname))
+    return 0;
+
+  std::fstream iofs;
+  IO::FRW::open_binary(iofs, fname, IO::FRW::read);
+
+  auto magic = std::uint64_t{0};
+  IO::FRW::rw_binary(iofs, IO::FRW::read, magic);
+  if (!iofs || magic != magic_number) {
+    std::cout << "\nError 48 in Kion::PartialResults: " << fname
+              << " is not a K(E,q) partial-results file\n";
+    return 0;
+  }
+  std::string identity;
+  IO::FRW::rw_binary(iofs, IO::FRW::read, identity);
+  if (identity != m_identity) {
+    std::cout << "\nError 55 in Kion::PartialResults: " << fname
+              << " was written for a different calculation; not used\n"
+              << " Expected: " << m_identity << "\n"
+              << " Found   : " << identity << "\n";
+    return 0;
+  }
+
+  const auto file_size = std::filesystem::file_size(fname);
+  std::size_t count = 0;
+  auto end_of_last_record = iofs.tellg();
+  while (iofs.peek() != std::char_traits<char>::eof()) {
+    int n{0}, kappa{0};
+    std::size_t iE_begin{0}, iE_end{0};
+    IO::FRW::rw_binary(iofs, IO::FRW::read, n, kappa, iE_begin, iE_end);
+    // nb: guard against corrupted record (don't trust sizes)
+    const auto bytes_left = file_size - std::uintmax_t(iofs.tellg());
+    if (!iofs || iE_end <= iE_begin ||
+        (iE_end - iE_begin) * m_num_q * sizeof(double) > bytes_left) {
+      iofs.setstate(std::ios_base::failbit);
+      break;
+    }
+    LinAlg::Matrix<double> K(iE_end - iE_begin, m_num_q);
+    iofs.read(reinterpret_cast<char *>(K.data()),
+              long(K.size() * sizeof(double)));
+    // incomplete final record: calculation was killed while writing
+    if (!iofs)
+      break;
+    m_units.insert_or_assign({n, kappa, iE_begin}, std::move(K));
+    ++count;
+    end_of_last_record = iofs.tellg();
+  }
+
+  // If this is the file we will append to, remove any incomplete record
+  if (fname == m_fname && iofs.fail()) {
+    iofs.close();
+    std::filesystem::resize_file(fname,
+                                 std::uintmax_t(end_of_last_record));
+  }
+  return count;
+}
+
+//------------------------------------------------------------------------------
+bool PartialResults::has(const WorkUnit &unit) const {
+  const auto it = m_units.find({unit.n, unit.kappa, unit.iE_begin});
+  return it != m_units.end() &&
+         it->second.rows() == unit.iE_end - unit.iE_begin;
+}
+
+//------------------------------------------------------------------------------
+void PartialResults::add(const WorkUnit &unit,
+                         const LinAlg::Matrix<double> &K) {
+  assert(K.rows() == unit.iE_end - unit.iE_begin && K.cols() == m_num_q);
+  m_units.insert_or_assign({unit.n, unit.kappa, unit.iE_begin}, K);
+
+  if (m_fname.empty())
+    return;
+
+  const auto new_file = !IO::FRW::file_exists(m_fname);
+  std::fstream ofs(m_fname, std::ios_base::out | std::ios_base::binary |
+                                std::ios_base::app);
+  if (new_file) {
+    auto magic = magic_number;
+    auto identity = m_identity;
+    IO::FRW::rw_binary(ofs, IO::FRW::write, magic, identity);
+  }
+  auto [n, kappa, iE_begin, iE_end] = unit;
+  IO::FRW::rw_binary(ofs, IO::FRW::write, n, kappa, iE_begin, iE_end);
+  ofs.write(reinterpret_cast<const char *>(K.data()),
+            long(K.size() * sizeof(double)));
+  ofs.flush();
+}
+
+//------------------------------------------------------------------------------
+LinAlg::Matrix<double> PartialResults::K_nk(int n, int kappa,
+                                            std::size_t num_E) const {
+  LinAlg::Matrix<double> K(num_E, m_num_q);
+  for (const auto &[key, K_unit] : m_units) {
+    const auto [un, ukappa, iE_begin] = key;
+    if (un != n || ukappa != kappa)
+      continue;
+    for (std::size_t i = 0; i < K_unit.rows() && iE_begin + i < num_E; ++i) {
+      std::copy(K_unit[i], K_unit[i] + m_num_q, K[iE_begin + i]);
+    }
+  }
+  return K;
+}
+
+} // namespace Kion
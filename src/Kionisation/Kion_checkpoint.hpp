@@ -0,0 +1,77 @@
+#pragma once
+#include "LinAlg/Matrix.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+class DiracSpinor;
+class Grid;
+
+namespace Kion {
+
+//! A single, independent unit of work: K(E,q) for one core shell, {n,kappa},
+//! over energy-grid points [iE_begin, iE_end)
+struct WorkUnit {
+  int n;
+  int kappa;
+  std::size_t iE_begin;
+  std::size_t iE_end;
+};
+
+//! Splits calculation into work units: one per (accessible) core shell and
+//! chunk of E_chunk energy-grid points. E_chunk=0 means one chunk per shell.
+std::vector<WorkUnit> make_work_units(const std::vector<DiracSpinor> &core,
+                                      const Grid &Egrid,
+                                      std::size_t E_chunk);
+
+//==============================================================================
+/*!
+@brief Stores completed K(E,q) work units; used for checkpoint/restart.
+@details
+Each completed unit is appended (binary) to a partial-results file as soon as
+it is added, and the file is flushed; a killed calculation loses at most the
+units in progress. On restart, the file is read back and completed units are
+skipped. Partial files written by separate processes (see WorkUnit) can be
+read into the same object, and merged.
+
+The file begins with an identity string (describing the method, options, and
+E and q grids); files with a different identity are refused. An incomplete
+final record (e.g., if killed while writing) is ignored.
+*/
+class PartialResults {
+  std::string m_fname;
+  std::string m_identity;
+  std::size_t m_num_q;
+  // {n, kappa, iE_begin} -> K for that unit: {iE - iE_begin, iq}
+  std::map<std::tuple<int, int, std::size_t>, LinAlg::Matrix<double>>
+      m_units{};
+
+public:
+  //! fname is the file completed units are written to (may be empty, in
+  //! which case nothing is written). identity should uniquely describe the
+  //! calculation (units from files with different identity are not used)
+  PartialResults(std::string fname, std::string identity, std::size_t num_q);
+
+  //! Reads completed units from file (not necessarily the one being written
+  //! to). Returns number of units read; prints error if identity differs
+  std::size_t read(const std::string &fname);
+
+  //! True if given unit has been completed
+  bool has(const WorkUnit &unit) const;
+
+  //! Stores result for a completed unit, and appends it to the output file
+  void add(const WorkUnit &unit, const LinAlg::Matrix<double> &K);
+
+  //! Number of completed units
+  std::size_t size() const { return m_units.size(); }
+
+  //! Assembles the full K(E,q) matrix (num_E rows) for given core shell from
+  //! the stored units. Missing units are left as zero.
+  LinAlg::Matrix<double> K_nk(int n, int kappa, std::size_t num_E) const;
+
+private:
+  static constexpr std::uint64_t magic_number = 0x4b696f6e50617274; // KionPart
+};
+
+} // namespace Kion
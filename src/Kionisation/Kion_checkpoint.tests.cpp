@@ -0,0 +1,84 @@
+#include "Kionisation/Kion_checkpoint.hpp"
+#include "LinAlg/Matrix.hpp"
+#include "catch2/catch.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+//==============================================================================
+TEST_CASE("Kionisation: checkpoint/restart", "[Kionisation][unit]") {
+
+  const std::string fname0 = "deleteme_Kion_part0.kpart";
+  const std::string fname1 = "deleteme_Kion_part1.kpart";
+  std::remove(fname0.c_str());
+  std::remove(fname1.c_str());
+
+  const std::size_t num_E = 10, num_q = 3;
+  const std::string id = "test K(E,q)";
+
+  // Two shells, E-chunks of 4 points: 6 work units
+  std::vector<Kion::WorkUnit> units;
+  for (const auto &[n, kappa] : {std::pair{1, -1}, std::pair{2, 1}}) {
+    for (std::size_t i0 = 0; i0 < num_E; i0 += 4) {
+      units.push_back({n, kappa, i0, std::min(i0 + 4, num_E)});
+    }
+  }
+  const auto K_unit = [&](const Kion::WorkUnit &u) {
+    LinAlg::Matrix<double> K(u.iE_end - u.iE_begin, num_q);
+    for (std::size_t i = 0; i < K.rows(); ++i)
+      for (std::size_t j = 0; j < K.cols(); ++j)
+        K(i, j) =
+            u.n + 0.1 * u.kappa + double(u.iE_begin + i) + 0.01 * double(j);
+    return K;
+  };
+
+  // "farm out" the units to two processes
+  {
+    Kion::PartialResults r0(fname0, id, num_q);
+    Kion::PartialResults r1(fname1, id, num_q);
+    for (std::size_t iu = 0; iu < units.size(); ++iu) {
+      (iu % 2 == 0 ? r0 : r1).add(units[iu], K_unit(units[iu]));
+    }
+    REQUIRE(r0.size() == 3);
+    REQUIRE(r1.size() == 3);
+  }
+
+  // Simulate second process being killed mid-write
+  std::filesystem::resize_file(fname1,
+                               std::filesystem::file_size(fname1) - 20);
+
+  // Restart from the partial file: last unit is lost
+  {
+    Kion::PartialResults r1(fname1, id, num_q);
+    REQUIRE(r1.read(fname1) == 2);
+    REQUIRE(!r1.has(units[5]));
+    // incomplete record was removed; appending again works
+    r1.add(units[5], K_unit(units[5]));
+  }
+
+  // Wrong identity is not read
+  {
+    Kion::PartialResults r(fname0, "a different calculation", num_q);
+    REQUIRE(r.read(fname0) == 0);
+  }
+
+  // Merge, and compare assembled results
+  Kion::PartialResults merged("", id, num_q);
+  REQUIRE(merged.read(fname0) == 3);
+  REQUIRE(merged.read(fname1) == 3);
+  for (const auto &u : units) {
+    REQUIRE(merged.has(u));
+  }
+  for (const auto &[n, kappa] : {std::pair{1, -1}, std::pair{2, 1}}) {
+    const auto K = merged.K_nk(n, kappa, num_E);
+    REQUIRE(K.rows() == num_E);
+    for (std::size_t iE = 0; iE < num_E; ++iE) {
+      for (std::size_t iq = 0; iq < num_q; ++iq) {
+        REQUIRE(K(iE, iq) == n + 0.1 * kappa + double(iE) + 0.01 * double(iq));
+      }
+    }
+  }
+
+  std::remove(fname0.c_str());
+  std::remove(fname1.c_str());
+}
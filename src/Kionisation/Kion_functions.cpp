@@ -5,6 +5,7 @@
 #include "HF/HartreeFock.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "Maths/Grid.hpp"
+#include "Maths/Interpolator.hpp"
 #include "Physics/PhysConst_constants.hpp"
 #include "Physics/UnitConv_conversions.hpp"
 #include "Wavefunction/ContinuumOrbitals.hpp"
@@ -13,8 +14,13 @@
 #include "fmt/ostream.hpp"
 #include "qip/Methods.hpp"
 #include "qip/omp.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace Kion {
 
@@ -27,19 +33,35 @@ calculateK_nk(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
               const std::vector<DiracSpinor> &basis) {
   assert(vHF != nullptr && "Hartree-Fock potential must not be null");
 
-  const auto &qgrid = jl->q_grid();
-  const auto qsteps = qgrid.num_points();
-
-  LinAlg::Matrix Knk_Eq(Egrid.num_points(), qgrid.num_points());
+  if (std::abs(Fnk.en()) > Egrid.r().back()) {
+    return {Egrid.num_points(), jl->q_grid().num_points()};
+  }
 
   std::unique_ptr<ExternalField::DiagramRPA0_jL> rpa{nullptr};
   if (use_rpa0)
     rpa =
         std::make_unique<ExternalField::DiagramRPA0_jL>(jl, basis, vHF, max_L);
 
-  if (std::abs(Fnk.en()) > Egrid.r().back()) {
-    return Knk_Eq;
-  }
+  return calculateK_nk_Erange(vHF, Fnk, max_L, Egrid, 0, Egrid.num_points(),
+                              jl, force_rescale, hole_particle, force_orthog,
+                              zeff_cont, rpa.get());
+}
+
+//==============================================================================
+// K(E,q) for core state Fnk, for arbitrary list of energy-deposition values.
+// Returned matrix: {dE, q}. Each dE requires a continuum solve.
+static LinAlg::Matrix<double>
+calculateK_nk_dE(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
+                 const std::vector<double> &dE_list,
+                 const DiracOperator::jL *jl, bool force_rescale,
+                 bool hole_particle, bool force_orthog, bool zeff_cont,
+                 const ExternalField::DiagramRPA0_jL *rpa) {
+  assert(vHF != nullptr && "Hartree-Fock potential must not be null");
+
+  const auto &qgrid = jl->q_grid();
+  const auto qsteps = qgrid.num_points();
+
+  LinAlg::Matrix Knk_Eq(dE_list.size(), qgrid.num_points());
 
   // Definition of matrix element:
   // matrix element defined such that:
@@ -56,11 +78,10 @@ calculateK_nk(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
   // }
   // Note: 'subtract 1' feature moved into definition of operator
 
-  // Find first energy grid point for which Fnk is accessible:
-  const auto idE_first_accessible = std::size_t(std::distance(
-      Egrid.begin(), std::find_if(Egrid.begin(), Egrid.end(),
-                                  [&](auto e) { return e > -Fnk.en(); })));
-  const auto num_accessible_E_steps = Egrid.num_points() - idE_first_accessible;
+  // Number of energy points for which Fnk is accessible:
+  const auto num_accessible_E_steps = std::size_t(
+      std::count_if(dE_list.cbegin(), dE_list.cend(),
+                    [&](auto e) { return e > -Fnk.en(); }));
 
   // decide what to parallelise over:
   const bool parallelise_E =
@@ -69,9 +90,8 @@ calculateK_nk(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
 
   (void)parallelise_E; //suppress unused variable warning clang, when no OMP
 #pragma omp parallel for if (parallelise_E)
-  for (std::size_t idE = idE_first_accessible; idE < Egrid.num_points();
-       ++idE) {
-    const auto dE = Egrid(idE);
+  for (std::size_t idE = 0; idE < dE_list.size(); ++idE) {
+    const auto dE = dE_list[idE];
 
     // Convert energy deposition to contimuum state energy:
     double ec = dE + Fnk.en();
@@ -97,16 +117,23 @@ calculateK_nk(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
                             hole_particle, force_orthog);
     }
 
+    // <e||jL(q)||nk> for all q and continuum states e, for each L: {q, e}
+    std::vector<LinAlg::Matrix<double>> me_L;
+    for (std::size_t L = 0; L <= std::size_t(max_L); L++) {
+      me_L.push_back(jl->rme_q(cntm.orbitals, Fnk, L));
+    }
+
 // Generate AK for each L, lc, and q
 // L and lc are summed, not stored individually
 #pragma omp parallel for if (!parallelise_E)
     for (std::size_t iq = 0; iq < qsteps; iq++) {
       for (std::size_t L = 0; L <= std::size_t(max_L); L++) {
-        for (const auto &Fe : cntm.orbitals) {
+        for (std::size_t ie = 0; ie < cntm.orbitals.size(); ++ie) {
+          const auto &Fe = cntm.orbitals[ie];
           if (jl->is_zero(Fe, Fnk, L))
             continue;
           const auto q = jl->q_grid().r(iq);
-          auto me = jl->rme(Fe, Fnk, L, q);
+          auto me = me_L[L](iq, ie);
           if (rpa) {
             // nb: only first-order core-pol
             me += rpa->dV_diagram_jL(Fe, Fnk, jl, L, q);
@@ -122,6 +149,162 @@ calculateK_nk(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
   return Knk_Eq;
 }
 
+//==============================================================================
+LinAlg::Matrix<double> calculateK_nk_Erange(
+    const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
+    const Grid &Egrid, std::size_t iE_begin, std::size_t iE_end,
+    const DiracOperator::jL *jl, bool force_rescale, bool hole_particle,
+    bool force_orthog, bool zeff_cont,
+    const ExternalField::DiagramRPA0_jL *rpa) {
+  assert(iE_begin <= iE_end && iE_end <= Egrid.num_points());
+  // Row i corresponds to Egrid point iE_begin + i
+  const std::vector<double> dE_list(Egrid.begin() + long(iE_begin),
+                                    Egrid.begin() + long(iE_end));
+  return calculateK_nk_dE(vHF, Fnk, max_L, dE_list, jl, force_rescale,
+                          hole_particle, force_orthog, zeff_cont, rpa);
+}
+
+//==============================================================================
+// Interpolates K(t,q), known at nodes {t, K(q)}, onto t_out (cubic spline,
+// separately for each q). Returned matrix: {t_out, q}
+static LinAlg::Matrix<double>
+interpolate_nodes(const std::map<double, std::vector<double>> &nodes,
+                  const std::vector<double> &t_out, std::size_t num_q) {
+  std::vector<double> t_in, K_in(nodes.size());
+  t_in.reserve(nodes.size());
+  for (const auto &node : nodes) {
+    t_in.push_back(node.first);
+  }
+  LinAlg::Matrix<double> K_out(t_out.size(), num_q);
+  for (std::size_t iq = 0; iq < num_q; ++iq) {
+    std::transform(nodes.cbegin(), nodes.cend(), K_in.begin(),
+                   [iq](const auto &node) { return node.second[iq]; });
+    const Interpolator::Interp K_of_t(t_in, K_in);
+    for (std::size_t i = 0; i < t_out.size(); ++i) {
+      K_out(i, iq) = K_of_t(t_out[i]);
+    }
+  }
+  return K_out;
+}
+
+//==============================================================================
+std::pair<LinAlg::Matrix<double>, std::size_t> calculateK_nk_adaptive(
+    const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
+    const Grid &Egrid, std::size_t iE_begin, std::size_t iE_end,
+    const DiracOperator::jL *jl, bool force_rescale, bool hole_particle,
+    bool force_orthog, bool zeff_cont, double tolerance,
+    const ExternalField::DiagramRPA0_jL *rpa) {
+  assert(iE_begin <= iE_end && iE_end <= Egrid.num_points());
+  const auto num_q = jl->q_grid().num_points();
+
+  // Initial (coarse) number of points. If output range is not much larger
+  // than this, no point doing anything clever
+  constexpr std::size_t num_initial = 9;
+
+  // K = 0 below threshold; only accessible part of the range is calculated
+  auto i0 = iE_begin;
+  while (i0 < iE_end && Egrid(i0) <= -Fnk.en())
+    ++i0;
+  const auto num_E = iE_end - i0;
+  if (num_E <= num_initial) {
+    return {calculateK_nk_Erange(vHF, Fnk, max_L, Egrid, iE_begin, iE_end, jl,
+                                 force_rescale, hole_particle, force_orthog,
+                                 zeff_cont, rpa),
+            num_E};
+  }
+
+  // Work in t = ln(E): output grid is (usually) logarithmic.
+  const auto t0 = std::log(Egrid(i0));
+  const auto t1 = std::log(Egrid(iE_end - 1));
+  // Never refine below half the (average) spacing of the output grid
+  const auto min_dt = 0.5 * (t1 - t0) / double(num_E - 1);
+
+  std::size_t num_solves = 0;
+  std::map<double, std::vector<double>> nodes;
+  // Calculates K at each t, and stores as nodes. Returns K: {t, q}
+  const auto calculate = [&](const std::vector<double> &t_list) {
+    std::vector<double> dE_list(t_list.size());
+    std::transform(t_list.cbegin(), t_list.cend(), dE_list.begin(),
+                   [](double t) { return std::exp(t); });
+    auto K = calculateK_nk_dE(vHF, Fnk, max_L, dE_list, jl, force_rescale,
+                              hole_particle, force_orthog, zeff_cont, rpa);
+    for (std::size_t i = 0; i < t_list.size(); ++i) {
+      nodes[t_list[i]] = std::vector<double>(K[i], K[i] + num_q);
+    }
+    num_solves += t_list.size();
+    return K;
+  };
+
+  // Initial coarse grid; every interval is a candidate for refinement
+  std::vector<double> t_list(num_initial);
+  for (std::size_t i = 0; i < num_initial; ++i) {
+    t_list[i] = t0 + (t1 - t0) * double(i) / double(num_initial - 1);
+  }
+  t_list.back() = t1;
+  calculate(t_list);
+  std::vector<std::pair<double, double>> active;
+  for (std::size_t i = 0; i + 1 < num_initial; ++i) {
+    active.emplace_back(t_list[i], t_list[i + 1]);
+  }
+
+  // Bisect each active interval: compare K at mid-point to the value
+  // interpolated from the existing nodes. If error is too large, both halves
+  // remain active. Error is relative to the largest K (over all E and q).
+  while (!active.empty()) {
+    std::vector<double> t_mid;
+    for (const auto &[ta, tb] : active) {
+      if (0.5 * (tb - ta) >= min_dt)
+        t_mid.push_back(0.5 * (ta + tb));
+    }
+    if (t_mid.empty())
+      break;
+
+    const auto K_interp = interpolate_nodes(nodes, t_mid, num_q);
+    const auto K_mid = calculate(t_mid);
+
+    double K_max = 0.0;
+    for (const auto &node : nodes) {
+      for (const auto K : node.second) {
+        K_max = std::max(K_max, std::abs(K));
+      }
+    }
+
+    std::vector<std::pair<double, double>> next_active;
+    std::size_t i = 0;
+    for (const auto &[ta, tb] : active) {
+      if (0.5 * (tb - ta) < min_dt)
+        continue;
+      double delta = 0.0;
+      for (std::size_t iq = 0; iq < num_q; ++iq) {
+        delta = std::max(delta, std::abs(K_mid(i, iq) - K_interp(i, iq)));
+      }
+      if (delta > tolerance * K_max) {
+        next_active.emplace_back(ta, t_mid[i]);
+        next_active.emplace_back(t_mid[i], tb);
+      }
+      ++i;
+    }
+    active = std::move(next_active);
+  }
+
+  // Interpolate onto the requested grid
+  std::vector<double> t_out;
+  t_out.reserve(num_E);
+  for (auto iE = i0; iE < iE_end; ++iE) {
+    t_out.push_back(std::log(Egrid(iE)));
+  }
+  t_out.front() = t0;
+  t_out.back() = t1;
+  const auto K_out = interpolate_nodes(nodes, t_out, num_q);
+
+  // Row i corresponds to Egrid point iE_begin + i
+  LinAlg::Matrix<double> Knk_Eq(iE_end - iE_begin, num_q);
+  for (std::size_t i = 0; i < num_E; ++i) {
+    std::copy(K_out[i], K_out[i] + num_q, Knk_Eq[i0 - iE_begin + i]);
+  }
+  return {Knk_Eq, num_solves};
+}
+
 //==============================================================================
 std::vector<LinAlg::Matrix<double>> calculateK_nk_rpa(
     const HF::HartreeFock *vHF, const std::vector<DiracSpinor> &core, int max_L,
@@ -253,16 +436,23 @@ calculateK_nk_approx(const HF::HartreeFock *vHF,
                             hole_particle, force_orthog);
     }
 
+    // <e||jL(q)||nk> for all q and continuum states e, for each L: {q, e}
+    std::vector<LinAlg::Matrix<double>> me_L;
+    for (std::size_t L = 0; L <= std::size_t(max_L); L++) {
+      me_L.push_back(jl->rme_q(cntm.orbitals, Fnk, L));
+    }
+
     // Generate AK for each L, lc, and q
     // L and lc are summed, not stored individually
 #pragma omp parallel for
     for (std::size_t iq = 0; iq < qsteps; iq++) {
       for (std::size_t L = 0; L <= std::size_t(max_L); L++) {
-        for (const auto &Fe : cntm.orbitals) {
+        for (std::size_t ie = 0; ie < cntm.orbitals.size(); ++ie) {
+          const auto &Fe = cntm.orbitals[ie];
           if (jl->is_zero(Fe, Fnk, L))
             continue;
           const auto q = jl->q_grid().r(iq);
-          auto me = jl->rme(Fe, Fnk, L, q);
+          auto me = me_L[L](iq, ie);
           if (rpa) {
             // nb: only first-order core-pol
             me += rpa->dV_diagram_jL(Fe, Fnk, jl, L, q);
@@ -1,11 +1,15 @@
 #pragma once
 #include "DiracOperator/Operators/jL.hpp"
 #include "LinAlg/Matrix.hpp"
+#include <utility>
 class DiracSpinor;
 class Grid;
 namespace HF {
 class HartreeFock;
 }
+namespace ExternalField {
+class DiagramRPA0_jL;
+}
 
 namespace Kion {
 
@@ -48,6 +52,36 @@ calculateK_nk(const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
               bool zeff_cont, bool use_rpa0 = false,
               const std::vector<DiracSpinor> &basis = {});
 
+//! As calculateK_nk, but only for energy-grid points [iE_begin, iE_end).
+/*! @details
+Returned matrix has (iE_end - iE_begin) rows; row i corresponds to Egrid point
+iE_begin + i. Used to split the calculation into independent work units.
+rpa0 is the (optional) lowest-order RPA object; if null, RPA not included.
+*/
+LinAlg::Matrix<double> calculateK_nk_Erange(
+    const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
+    const Grid &Egrid, std::size_t iE_begin, std::size_t iE_end,
+    const DiracOperator::jL *jl, bool force_rescale, bool hole_particle,
+    bool force_orthog, bool zeff_cont,
+    const ExternalField::DiagramRPA0_jL *rpa0 = nullptr);
+
+//! As calculateK_nk_Erange, but with adaptive energy grid.
+/*! @details
+Continuum states are solved on a coarse (logarithmic) energy grid, which is
+refined by bisection only where the interpolation error of K(E,q) is larger
+than tolerance (relative to the largest K, over all E and q). The result is
+then interpolated (cubic spline in ln E) onto the requested grid points.
+K(E,q) is calculated for all q for each continuum solution, so only E is
+refined.
+Returns {K, number of continuum solves}.
+*/
+std::pair<LinAlg::Matrix<double>, std::size_t> calculateK_nk_adaptive(
+    const HF::HartreeFock *vHF, const DiracSpinor &Fnk, int max_L,
+    const Grid &Egrid, std::size_t iE_begin, std::size_t iE_end,
+    const DiracOperator::jL *jl, bool force_rescale, bool hole_particle,
+    bool force_orthog, bool zeff_cont, double tolerance,
+    const ExternalField::DiagramRPA0_jL *rpa0 = nullptr);
+
 //! Calculates ionisation factor K(E,q), for all core states, in RPA approximation.
 //! Uses all-orders RPA, so is quite slow (RPA must be solved for each L and q)
 std::vector<LinAlg::Matrix<double>> calculateK_nk_rpa(
@@ -1,17 +1,22 @@
 #include "Kionisation/Module_Kionisation.hpp"
 #include "DiracOperator/DiracOperator.hpp"
+#include "ExternalField/DiagramRPA0_jL.hpp"
 #include "IO/ChronoTimer.hpp"
 #include "IO/InputBlock.hpp"
+#include "Kionisation/Kion_checkpoint.hpp"
 #include "Kionisation/Kion_functions.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "Maths/Grid.hpp"
 #include "Physics/PhysConst_constants.hpp"
 #include "Physics/UnitConv_conversions.hpp"
+#include "Wavefunction/ContinuumOrbitals.hpp"
 #include "Wavefunction/Wavefunction.hpp"
 #include "fmt/color.hpp"
 #include "fmt/ostream.hpp"
 #include "qip/Methods.hpp"
 #include "qip/String.hpp"
+#include "qip/omp.hpp"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <memory>
@@ -33,6 +38,30 @@ Method:
   - Other methods (Zeff etc.) are mainly used for tests, and to compare with 
     other less accurate codes. These are not accurate methods to use.
 
+Adaptive energy grid (hf, rpa0, and zeff methods only):
+  - With 'adaptive = tol;' (e.g., 1.0e-2), the continuum equations are solved
+    on a coarse energy grid, which is refined by bisection only where the
+    interpolation error of K(E,q) (relative to the maximum of K) exceeds tol.
+    The output is interpolated onto the requested E grid.
+  - This is typically several times fewer continuum solves for smooth K(E,q).
+    Each solve gives K for every q, so the q grid is always calculated fully.
+  - There is little point choosing tol much smaller than ~1e-3, which is
+    roughly the numerical noise in K(E,q) from the continuum solutions.
+
+Checkpoint/restart (hf, rpa0, and zeff methods only):
+  - Calculation is split into independent work units: one per core shell and
+    chunk of 'E_chunk' energy points.
+  - 'checkpoint' writes each completed unit to the partial-results file
+    <output name>.kpart as soon as it's done. If this file exists, completed
+    units are read in and skipped, so a killed calculation can be restarted.
+  - 'part = i, N;' calculates only every N-th unit (starting from i, with
+    i=0,1,...,N-1), and writes them to <output name>_part{i}of{N}.kpart. This
+    allows units to be farmed out to separate processes/hosts. The final output
+    is only written once all units are complete.
+  - 'merge' lists partial-results files (e.g., from 'part' runs) to read in
+    first; only missing units are then calculated, and the full result is
+    written. Units in any of these files must come from an identical input.
+
 Output format:
   - xyz:      For easy 2D interpolation. Each row is in form: 'E q K(E,q)'
   - gnuplot:  For easy plotting. Each column is new E
@@ -76,7 +105,23 @@ void Kionisation(const IO::InputBlock &input, const Wavefunction &wf) {
        {"units",
         "Units for 'gnuplot' output: Particle (keV/MeV) or Atomic (E_H,1/a0). "
         "Only affects _gnu output format, all _mat and _xyz are "
-        "always in atomic units. [Particle]"}});
+        "always in atomic units. [Particle]"},
+       {"adaptive", "Relative tolerance for adaptive E grid (hf, rpa0, zeff "
+                    "methods). If >0, continuum states are only solved on a "
+                    "refined subset of the E grid, and K(E,q) is interpolated "
+                    "onto the full grid. 0 to solve at every E [0]"},
+       {"E_chunk", "Number of E grid points per work unit (for checkpoint or "
+                   "part). 0 means one unit per core shell [16, or 0 if "
+                   "adaptive]"},
+       {"checkpoint", "bool. Write completed work units to <output>.kpart, "
+                      "and restart from it if it exists [false]"},
+       {"part", "List (2): i, N. Only calculate every N-th work unit, starting "
+                "from i; written to <output>_part{i}of{N}.kpart [0, 1]"},
+       {"merge", "List: partial-results (.kpart) files to read in before "
+                 "calculating; only missing units are calculated []"},
+       {"cntm_cache", "Memory budget (MB) for cache of continuum solutions; "
+                      "avoids re-solving identical continuum states. 0 to "
+                      "disable [256]"}});
   if (input.has_option("help")) {
     std::cout << Kionisation_description_text;
     return;
@@ -266,21 +311,30 @@ void Kionisation(const IO::InputBlock &input, const Wavefunction &wf) {
     return;
   }
 
+  // Every matrix element involves a core (or basis) state, so jL table is
+  // only required out to furthest extent of these
+  std::size_t max_pt = 0;
+  for (const auto *orbs : {&wf.core(), &wf.basis()}) {
+    for (const auto &Fn : *orbs) {
+      max_pt = std::max(max_pt, Fn.max_pt());
+    }
+  }
+
   // Construct the effective electron-coupling operator.
   // Uses pointers, since we use polymorphism to swap between coupling types
   std::unique_ptr<DiracOperator::jL> jl = nullptr;
   if (coupling == Kion::Coupling::Vector) {
-    jl = std::make_unique<DiracOperator::jL>(wf.grid(), qgrid,
-                                             std::size_t(max_L), subtract_1);
+    jl = std::make_unique<DiracOperator::jL>(
+        wf.grid(), qgrid, std::size_t(max_L), subtract_1, max_pt);
   } else if (coupling == Kion::Coupling::Scalar) {
-    jl = std::make_unique<DiracOperator::g0jL>(wf.grid(), qgrid,
-                                               std::size_t(max_L), subtract_1);
+    jl = std::make_unique<DiracOperator::g0jL>(
+        wf.grid(), qgrid, std::size_t(max_L), subtract_1, max_pt);
   } else if (coupling == Kion::Coupling::PseudoVector) {
     jl = std::make_unique<DiracOperator::ig5jL>(wf.grid(), qgrid,
-                                                std::size_t(max_L));
+                                                std::size_t(max_L), max_pt);
   } else if (coupling == Kion::Coupling::PseudoScalar) {
     jl = std::make_unique<DiracOperator::ig0g5jL>(wf.grid(), qgrid,
-                                                  std::size_t(max_L));
+                                                  std::size_t(max_L), max_pt);
   }
   assert(jl != nullptr && "Error in coupling type");
   std::cout << "Operator: " << jl->name() << "\n";
@@ -387,6 +441,43 @@ void Kionisation(const IO::InputBlock &input, const Wavefunction &wf) {
 
   //----------------------------------------------------------------------------
 
+  // Adaptive E grid: works best with large E range per work unit
+  const auto adaptive_tol = input.get("adaptive", 0.0);
+  if (adaptive_tol > 0.0) {
+    fmt::print("Using adaptive E grid, with relative tolerance: {:.1e}\n",
+               adaptive_tol);
+  }
+
+  // Work units, checkpoint, and restart:
+  const auto E_chunk = input.get<std::size_t>(
+      "E_chunk",
+      adaptive_tol > 0.0 ?
+          0 :
+          std::max(std::size_t(16), std::size_t(omp_get_max_threads())));
+  auto [part_i, part_N] = input.get("part", std::array<std::size_t, 2>{0, 1});
+  if (part_N == 0 || part_i >= part_N) {
+    part_i = 0;
+    part_N = 1;
+  }
+  const auto merge_files = input.get<std::vector<std::string>>("merge", {});
+  const auto checkpoint = input.get("checkpoint", false) || part_N > 1;
+  const auto kpart_fname =
+      !checkpoint ? std::string{} :
+      part_N > 1  ? fmt::format("{}_part{}of{}.kpart", oname, part_i, part_N) :
+                    oname + ".kpart";
+  if ((checkpoint || !merge_files.empty()) &&
+      (method == Kion::Method::RPA || method == Kion::Method::Approx)) {
+    fmt2::styled_print(fg(fmt::color::orange), "\nWarning: ");
+    fmt::print("checkpoint/part/merge options only implemented for hf, rpa0, "
+               "and zeff methods; will be ignored\n");
+  }
+
+  // Cache of continuum solutions. Mainly helps the all-orders RPA method,
+  // which requires same continuum states for each L and q
+  const auto cntm_cache_MB = input.get("cntm_cache", 256.0);
+  ContinuumOrbitals::set_cache_budget(
+      std::size_t(std::max(0.0, cntm_cache_MB) * 1024 * 1024));
+
   std::cout << "\nCalculating K(E,q) - ionisation factor\n" << std::flush;
   const int num_output_digits = 5;
 
@@ -430,15 +521,92 @@ void Kionisation(const IO::InputBlock &input, const Wavefunction &wf) {
 
   } else {
     // all other methods (including standard)
+    // Split into work units: (core shell, E-chunk). Completed units are stored
+    // (and optionally written to partial-results file as they complete)
+
+    const auto work_units = Kion::make_work_units(wf.core(), Egrid, E_chunk);
+    const auto identity =
+        fmt::format("{} E:[{:.8e},{:.8e},{}] q:[{:.8e},{:.8e},{}] chunk:{} "
+                    "adaptive:{:.3e}",
+                    oname, Emin_au, Emax_au, Egrid.num_points(), qmin_au,
+                    qmax_au, qgrid.num_points(), E_chunk, adaptive_tol);
+    Kion::PartialResults results(kpart_fname, identity, qgrid.num_points());
+    for (const auto &fname : merge_files) {
+      const auto num_read = results.read(fname);
+      std::cout << "Read " << num_read << " completed work units from "
+                << fname << "\n";
+    }
+    if (!kpart_fname.empty()) {
+      const auto num_read = results.read(kpart_fname);
+      if (num_read > 0)
+        std::cout << "Restarting: read " << num_read
+                  << " completed work units from " << kpart_fname << "\n";
+      std::cout << "Writing completed work units to: " << kpart_fname << "\n";
+    }
+    std::cout << work_units.size() << " work units";
+    if (part_N > 1)
+      std::cout << ", calculating part " << part_i << "/" << part_N;
+    std::cout << "\n";
+
+    // Number of continuum solves (to show saving from adaptive grid)
+    std::size_t total_solves = 0, full_solves = 0;
+    for (const auto &Fnk : wf.core()) {
+      std::unique_ptr<ExternalField::DiagramRPA0_jL> rpa0{nullptr};
+      for (std::size_t iu = 0; iu < work_units.size(); ++iu) {
+        const auto &unit = work_units[iu];
+        if (unit.n != Fnk.n() || unit.kappa != Fnk.kappa() ||
+            iu % part_N != part_i || results.has(unit))
+          continue;
+        std::cout << Fnk << "[" << unit.iE_begin << "," << unit.iE_end
+                  << "), " << std::flush;
+        if (use_rpa0 && rpa0 == nullptr)
+          rpa0 = std::make_unique<ExternalField::DiagramRPA0_jL>(
+              jl.get(), wf.basis(), wf.vHF(), max_L);
+        if (adaptive_tol > 0.0) {
+          const auto [K_unit, num_solves] = Kion::calculateK_nk_adaptive(
+              wf.vHF(), Fnk, max_L, Egrid, unit.iE_begin, unit.iE_end,
+              jl.get(), force_rescale, hole_particle, force_orthog,
+              use_Zeff_cont, adaptive_tol, rpa0.get());
+          total_solves += num_solves;
+          results.add(unit, K_unit);
+        } else {
+          results.add(unit, Kion::calculateK_nk_Erange(
+                                wf.vHF(), Fnk, max_L, Egrid, unit.iE_begin,
+                                unit.iE_end, jl.get(), force_rescale,
+                                hole_particle, force_orthog, use_Zeff_cont,
+                                rpa0.get()));
+        }
+        for (auto iE = unit.iE_begin; iE < unit.iE_end; ++iE) {
+          if (Egrid(iE) > -Fnk.en())
+            ++full_solves;
+        }
+      }
+    }
+    std::cout << "\n";
+    if (adaptive_tol > 0.0 && full_solves > 0) {
+      fmt::print("Adaptive E grid: {} continuum solves, cf. {} for full grid "
+                 "({:.1f}x fewer)\n",
+                 total_solves, full_solves,
+                 double(full_solves) / double(std::max(total_solves, 1ul)));
+    }
+
+    const auto num_complete = std::size_t(
+        std::count_if(work_units.cbegin(), work_units.cend(),
+                      [&](const auto &unit) { return results.has(unit); }));
+    if (num_complete != work_units.size()) {
+      fmt::print("\n{}/{} work units complete. Merge partial-results files "
+                 "(see 'merge' option) to write final output\n",
+                 num_complete, work_units.size());
+      ContinuumOrbitals::clear_cache();
+      return;
+    }
 
     for (const auto &Fnk : wf.core()) {
       const auto accessible = std::abs(Fnk.en()) < Emax_au;
       if (!accessible)
         continue;
-      std::cout << Fnk << ", " << std::flush;
-      const auto K_nk = Kion::calculateK_nk(
-          wf.vHF(), Fnk, max_L, Egrid, jl.get(), force_rescale, hole_particle,
-          force_orthog, use_Zeff_cont, use_rpa0, wf.basis());
+      const auto K_nk =
+          results.K_nk(Fnk.n(), Fnk.kappa(), Egrid.num_points());
       if (write_each_state) {
         const auto oname_nk = oname + "_" + Fnk.shortSymbol();
         std::cout << "Written to file: " << oname_nk << "\n";
@@ -449,6 +617,15 @@ void Kionisation(const IO::InputBlock &input, const Wavefunction &wf) {
     }
   }
 
+  const auto [cache_hits, cache_misses, cache_bytes] =
+      ContinuumOrbitals::cache_stats();
+  if (cache_hits > 0) {
+    fmt::print("Continuum cache: {} re-used, {} solved ({:.1f} MB)\n",
+               cache_hits, cache_misses,
+               double(cache_bytes) / (1024.0 * 1024.0));
+  }
+  ContinuumOrbitals::clear_cache();
+
   std::cout << "\nWritten to file: " << oname << "\n";
   Kion::write_to_file(output_formats, Kion, Egrid, qgrid, oname,
                       num_output_digits, units);
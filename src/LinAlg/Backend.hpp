@@ -0,0 +1,377 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#ifdef LINALG_GSL_BACKEND
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_linalg.h>
+#endif
+
+//==============================================================================
+// Fortran BLAS/LAPACK routines (column-major). Complex types are passed as
+// std::complex<T>, which is layout-compatible with Fortran complex
+extern "C" {
+void sgemm_(const char *, const char *, const int *, const int *, const int *,
+            const float *, const float *, const int *, const float *,
+            const int *, const float *, float *, const int *);
+void dgemm_(const char *, const char *, const int *, const int *, const int *,
+            const double *, const double *, const int *, const double *,
+            const int *, const double *, double *, const int *);
+void cgemm_(const char *, const char *, const int *, const int *, const int *,
+            const std::complex<float> *, const std::complex<float> *,
+            const int *, const std::complex<float> *, const int *,
+            const std::complex<float> *, std::complex<float> *, const int *);
+void zgemm_(const char *, const char *, const int *, const int *, const int *,
+            const std::complex<double> *, const std::complex<double> *,
+            const int *, const std::complex<double> *, const int *,
+            const std::complex<double> *, std::complex<double> *,
+            const int *);
+
+void sgemv_(const char *, const int *, const int *, const float *,
+            const float *, const int *, const float *, const int *,
+            const float *, float *, const int *);
+void dgemv_(const char *, const int *, const int *, const double *,
+            const double *, const int *, const double *, const int *,
+            const double *, double *, const int *);
+void cgemv_(const char *, const int *, const int *,
+            const std::complex<float> *, const std::complex<float> *,
+            const int *, const std::complex<float> *, const int *,
+            const std::complex<float> *, std::complex<float> *, const int *);
+void zgemv_(const char *, const int *, const int *,
+            const std::complex<double> *, const std::complex<double> *,
+            const int *, const std::complex<double> *, const int *,
+            const std::complex<double> *, std::complex<double> *,
+            const int *);
+
+void dgetrf_(const int *, const int *, double *, const int *, int *, int *);
+void zgetrf_(const int *, const int *, std::complex<double> *, const int *,
+             int *, int *);
+void dgetri_(const int *, double *, const int *, const int *, double *,
+             const int *, int *);
+void zgetri_(const int *, std::complex<double> *, const int *, const int *,
+             std::complex<double> *, const int *, int *);
+void dgetrs_(const char *, const int *, const int *, const double *,
+             const int *, const int *, double *, const int *, int *);
+void zgetrs_(const char *, const int *, const int *,
+             const std::complex<double> *, const int *, const int *,
+             std::complex<double> *, const int *, int *);
+}
+
+//==============================================================================
+/*!
+@brief Low-level (row-major) BLAS/LAPACK calls used by Matrix/Vector/Solvers.
+@details
+By default, calls the Fortran BLAS/LAPACK routines directly: the matrix
+products then use whichever BLAS is linked via BLASLIB (e.g., openblas), rather
+than GSL's reference CBLAS (-lgslcblas); LU inversion etc. use LAPACK.
+Compiling with -DLINALG_GSL_BACKEND (LinAlgBackend=gsl in the Makefile) uses
+the GSL routines instead.
+
+All matrices are row-major, with leading dimension (row stride) ld. LAPACK is
+column-major, so sees the transpose; this is accounted for in each routine.
+*/
+namespace LinAlg::backend {
+
+//! Name of the backend in use
+inline const char *name() {
+#ifdef LINALG_GSL_BACKEND
+  return "GSL";
+#else
+  return "BLAS/LAPACK";
+#endif
+}
+
+//==============================================================================
+//! c = a*b, for (m x k) matrix a, (k x n) matrix b, and (m x n) matrix c.
+//! lda, ldb, ldc are the row strides (=k, n, n for contiguous matrices)
+template <typename T>
+void gemm(std::size_t m, std::size_t n, std::size_t k, const T *a,
+          std::size_t lda, const T *b, std::size_t ldb, T *c,
+          std::size_t ldc) {
+  if (m == 0 || n == 0)
+    return;
+  if (k == 0) {
+    for (std::size_t i = 0; i < m; ++i)
+      std::fill(c + i * ldc, c + i * ldc + n, T(0));
+    return;
+  }
+#ifdef LINALG_GSL_BACKEND
+  if constexpr (std::is_same_v<T, double>) {
+    const auto a_gsl = gsl_matrix_const_view_array_with_tda(a, m, k, lda);
+    const auto b_gsl = gsl_matrix_const_view_array_with_tda(b, k, n, ldb);
+    auto c_gsl = gsl_matrix_view_array_with_tda(c, m, n, ldc);
+    gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, &a_gsl.matrix,
+                   &b_gsl.matrix, 0.0, &c_gsl.matrix);
+  } else if constexpr (std::is_same_v<T, float>) {
+    const auto a_gsl =
+        gsl_matrix_float_const_view_array_with_tda(a, m, k, lda);
+    const auto b_gsl =
+        gsl_matrix_float_const_view_array_with_tda(b, k, n, ldb);
+    auto c_gsl = gsl_matrix_float_view_array_with_tda(c, m, n, ldc);
+    gsl_blas_sgemm(CblasNoTrans, CblasNoTrans, 1.0f, &a_gsl.matrix,
+                   &b_gsl.matrix, 0.0f, &c_gsl.matrix);
+  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
+    const auto a_gsl = gsl_matrix_complex_const_view_array_with_tda(
+        reinterpret_cast<const double *>(a), m, k, lda);
+    const auto b_gsl = gsl_matrix_complex_const_view_array_with_tda(
+        reinterpret_cast<const double *>(b), k, n, ldb);
+    auto c_gsl = gsl_matrix_complex_view_array_with_tda(
+        reinterpret_cast<double *>(c), m, n, ldc);
+    gsl_blas_zgemm(CblasNoTrans, CblasNoTrans, GSL_COMPLEX_ONE, &a_gsl.matrix,
+                   &b_gsl.matrix, GSL_COMPLEX_ZERO, &c_gsl.matrix);
+  } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+    const auto a_gsl = gsl_matrix_complex_float_const_view_array_with_tda(
+        reinterpret_cast<const float *>(a), m, k, lda);
+    const auto b_gsl = gsl_matrix_complex_float_const_view_array_with_tda(
+        reinterpret_cast<const float *>(b), k, n, ldb);
+    auto c_gsl = gsl_matrix_complex_float_view_array_with_tda(
+        reinterpret_cast<float *>(c), m, n, ldc);
+    const gsl_complex_float one{1.0f, 0.0f};
+    const gsl_complex_float zero{0.0f, 0.0f};
+    gsl_blas_cgemm(CblasNoTrans, CblasNoTrans, one, &a_gsl.matrix,
+                   &b_gsl.matrix, zero, &c_gsl.matrix);
+  }
+#else
+  // Column-major sees transposes: c^T = b^T * a^T
+  const auto M = int(n), N = int(m), K = int(k);
+  const auto LDA = int(ldb), LDB = int(lda), LDC = int(ldc);
+  const T one{1}, zero{0};
+  if constexpr (std::is_same_v<T, double>) {
+    dgemm_("N", "N", &M, &N, &K, &one, b, &LDA, a, &LDB, &zero, c, &LDC);
+  } else if constexpr (std::is_same_v<T, float>) {
+    sgemm_("N", "N", &M, &N, &K, &one, b, &LDA, a, &LDB, &zero, c, &LDC);
+  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
+    zgemm_("N", "N", &M, &N, &K, &one, b, &LDA, a, &LDB, &zero, c, &LDC);
+  } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+    cgemm_("N", "N", &M, &N, &K, &one, b, &LDA, a, &LDB, &zero, c, &LDC);
+  }
+#endif
+}
+
+//! c = a*b, for contiguous (m x k) matrix a, (k x n) b, and (m x n) c
+template <typename T>
+void gemm(std::size_t m, std::size_t n, std::size_t k, const T *a, const T *b,
+          T *c) {
+  gemm(m, n, k, a, k, b, n, c, n);
+}
+
+//==============================================================================
+//! y = a*x, for contiguous (m x n) matrix a, and vectors x (n) and y (m)
+template <typename T>
+void gemv(std::size_t m, std::size_t n, const T *a, const T *x, T *y) {
+  if (m == 0)
+    return;
+  if (n == 0) {
+    std::fill(y, y + m, T(0));
+    return;
+  }
+#ifdef LINALG_GSL_BACKEND
+  if constexpr (std::is_same_v<T, double>) {
+    const auto a_gsl = gsl_matrix_const_view_array(a, m, n);
+    const auto x_gsl = gsl_vector_const_view_array(x, n);
+    auto y_gsl = gsl_vector_view_array(y, m);
+    gsl_blas_dgemv(CblasNoTrans, 1.0, &a_gsl.matrix, &x_gsl.vector, 0.0,
+                   &y_gsl.vector);
+  } else if constexpr (std::is_same_v<T, float>) {
+    const auto a_gsl = gsl_matrix_float_const_view_array(a, m, n);
+    const auto x_gsl = gsl_vector_float_const_view_array(x, n);
+    auto y_gsl = gsl_vector_float_view_array(y, m);
+    gsl_blas_sgemv(CblasNoTrans, 1.0f, &a_gsl.matrix, &x_gsl.vector, 0.0f,
+                   &y_gsl.vector);
+  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
+    const auto a_gsl = gsl_matrix_complex_const_view_array(
+        reinterpret_cast<const double *>(a), m, n);
+    const auto x_gsl = gsl_vector_complex_const_view_array(
+        reinterpret_cast<const double *>(x), n);
+    auto y_gsl =
+        gsl_vector_complex_view_array(reinterpret_cast<double *>(y), m);
+    gsl_blas_zgemv(CblasNoTrans, GSL_COMPLEX_ONE, &a_gsl.matrix,
+                   &x_gsl.vector, GSL_COMPLEX_ZERO, &y_gsl.vector);
+  } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+    const auto a_gsl = gsl_matrix_complex_float_const_view_array(
+        reinterpret_cast<const float *>(a), m, n);
+    const auto x_gsl = gsl_vector_complex_float_const_view_array(
+        reinterpret_cast<const float *>(x), n);
+    auto y_gsl =
+        gsl_vector_complex_float_view_array(reinterpret_cast<float *>(y), m);
+    const gsl_complex_float one{1.0f, 0.0f};
+    const gsl_complex_float zero{0.0f, 0.0f};
+    gsl_blas_cgemv(CblasNoTrans, one, &a_gsl.matrix, &x_gsl.vector, zero,
+                   &y_gsl.vector);
+  }
+#else
+  // Column-major sees a^T (n x m): y = (a^T)^T x
+  const auto M = int(n), N = int(m), inc = 1;
+  const T one{1}, zero{0};
+  if constexpr (std::is_same_v<T, double>) {
+    dgemv_("T", &M, &N, &one, a, &M, x, &inc, &zero, y, &inc);
+  } else if constexpr (std::is_same_v<T, float>) {
+    sgemv_("T", &M, &N, &one, a, &M, x, &inc, &zero, y, &inc);
+  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
+    zgemv_("T", &M, &N, &one, a, &M, x, &inc, &zero, y, &inc);
+  } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+    cgemv_("T", &M, &N, &one, a, &M, x, &inc, &zero, y, &inc);
+  }
+#endif
+}
+
+//==============================================================================
+#ifndef LINALG_GSL_BACKEND
+namespace detail {
+// LU decomposition of (n x n) a, in place (LAPACK getrf). Returns info
+template <typename T>
+int getrf(int n, T *a, int *ipiv) {
+  int info = 0;
+  if constexpr (std::is_same_v<T, double>) {
+    dgetrf_(&n, &n, a, &n, ipiv, &info);
+  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
+    zgetrf_(&n, &n, a, &n, ipiv, &info);
+  }
+  return info;
+}
+} // namespace detail
+#endif
+
+//! Inverts the (n x n) matrix a in place, via LU decomposition. Returns 0 on
+//! success (non-zero if a is singular). Only double/complex<double>
+template <typename T>
+int invert(std::size_t n, T *a) {
+  static_assert(std::is_same_v<T, double> ||
+                std::is_same_v<T, std::complex<double>>);
+  if (n == 0)
+    return 0;
+#ifdef LINALG_GSL_BACKEND
+  // nb: gsl_linalg_LU_invx (in-place) is not in older GSL versions
+  std::vector<T> LU(a, a + n * n);
+  int sLU = 0;
+  gsl_permutation *permutn = gsl_permutation_alloc(n);
+  int info = 0;
+  if constexpr (std::is_same_v<T, double>) {
+    auto LU_gsl = gsl_matrix_view_array(LU.data(), n, n);
+    auto inv_gsl = gsl_matrix_view_array(a, n, n);
+    gsl_linalg_LU_decomp(&LU_gsl.matrix, permutn, &sLU);
+    info = gsl_linalg_LU_invert(&LU_gsl.matrix, permutn, &inv_gsl.matrix);
+  } else {
+    auto LU_gsl = gsl_matrix_complex_view_array(
+        reinterpret_cast<double *>(LU.data()), n, n);
+    auto inv_gsl =
+        gsl_matrix_complex_view_array(reinterpret_cast<double *>(a), n, n);
+    gsl_linalg_complex_LU_decomp(&LU_gsl.matrix, permutn, &sLU);
+    info =
+        gsl_linalg_complex_LU_invert(&LU_gsl.matrix, permutn, &inv_gsl.matrix);
+  }
+  gsl_permutation_free(permutn);
+  return info;
+#else
+  // Column-major sees a^T; inv(a^T) = inv(a)^T, so no transposes required
+  const auto N = int(n);
+  std::vector<int> ipiv(n);
+  auto info = detail::getrf(N, a, ipiv.data());
+  if (info != 0)
+    return info;
+  // workspace query first:
+  T work_size{0};
+  int lwork = -1;
+  if constexpr (std::is_same_v<T, double>) {
+    dgetri_(&N, a, &N, ipiv.data(), &work_size, &lwork, &info);
+  } else {
+    zgetri_(&N, a, &N, ipiv.data(), &work_size, &lwork, &info);
+  }
+  lwork = std::max(N, int(std::real(work_size)));
+  std::vector<T> work(static_cast<std::size_t>(lwork));
+  if constexpr (std::is_same_v<T, double>) {
+    dgetri_(&N, a, &N, ipiv.data(), work.data(), &lwork, &info);
+  } else {
+    zgetri_(&N, a, &N, ipiv.data(), work.data(), &lwork, &info);
+  }
+  return info;
+#endif
+}
+
+//! Determinant of (n x n) matrix a, via LU decomposition. a is overwritten.
+//! Only double/complex<double>
+template <typename T>
+T determinant(std::size_t n, T *a) {
+  static_assert(std::is_same_v<T, double> ||
+                std::is_same_v<T, std::complex<double>>);
+  if (n == 0)
+    return T(1);
+#ifdef LINALG_GSL_BACKEND
+  int sLU = 0;
+  gsl_permutation *permutn = gsl_permutation_alloc(n);
+  T det{0};
+  if constexpr (std::is_same_v<T, double>) {
+    auto gsl_view = gsl_matrix_view_array(a, n, n);
+    gsl_linalg_LU_decomp(&gsl_view.matrix, permutn, &sLU);
+    det = gsl_linalg_LU_det(&gsl_view.matrix, sLU);
+  } else {
+    auto gsl_view =
+        gsl_matrix_complex_view_array(reinterpret_cast<double *>(a), n, n);
+    gsl_linalg_complex_LU_decomp(&gsl_view.matrix, permutn, &sLU);
+    const auto gsl_cmplx = gsl_linalg_complex_LU_det(&gsl_view.matrix, sLU);
+    det = {GSL_REAL(gsl_cmplx), GSL_IMAG(gsl_cmplx)};
+  }
+  gsl_permutation_free(permutn);
+  return det;
+#else
+  // det(a^T) = det(a); singular matrix has zero on diagonal of U
+  std::vector<int> ipiv(n);
+  detail::getrf(int(n), a, ipiv.data());
+  T det{1};
+  for (std::size_t i = 0; i < n; ++i) {
+    det *= a[i * n + i];
+    if (ipiv[i] != int(i + 1))
+      det = -det;
+  }
+  return det;
+#endif
+}
+
+//! Solves a*x = b, for (n x n) matrix a; b is overwritten by the solution x,
+//! and a by its LU decomposition. Returns 0 on success (non-zero if a is
+//! singular). Only double/complex<double>
+template <typename T>
+int solve(std::size_t n, T *a, T *b) {
+  static_assert(std::is_same_v<T, double> ||
+                std::is_same_v<T, std::complex<double>>);
+  if (n == 0)
+    return 0;
+#ifdef LINALG_GSL_BACKEND
+  int sLU = 0;
+  gsl_permutation *permutn = gsl_permutation_alloc(n);
+  int info = 0;
+  if constexpr (std::is_same_v<T, double>) {
+    auto a_gsl = gsl_matrix_view_array(a, n, n);
+    auto b_gsl = gsl_vector_view_array(b, n);
+    gsl_linalg_LU_decomp(&a_gsl.matrix, permutn, &sLU);
+    info = gsl_linalg_LU_svx(&a_gsl.matrix, permutn, &b_gsl.vector);
+  } else {
+    auto a_gsl =
+        gsl_matrix_complex_view_array(reinterpret_cast<double *>(a), n, n);
+    auto b_gsl =
+        gsl_vector_complex_view_array(reinterpret_cast<double *>(b), n);
+    gsl_linalg_complex_LU_decomp(&a_gsl.matrix, permutn, &sLU);
+    info = gsl_linalg_complex_LU_svx(&a_gsl.matrix, permutn, &b_gsl.vector);
+  }
+  gsl_permutation_free(permutn);
+  return info;
+#else
+  // Column-major sees a^T; so solve (a^T)^T x = b
+  const auto N = int(n), nrhs = 1;
+  std::vector<int> ipiv(n);
+  auto info = detail::getrf(N, a, ipiv.data());
+  if (info != 0)
+    return info;
+  if constexpr (std::is_same_v<T, double>) {
+    dgetrs_("T", &N, &nrhs, a, &N, ipiv.data(), b, &N, &info);
+  } else {
+    zgetrs_("T", &N, &nrhs, a, &N, ipiv.data(), b, &N, &info);
+  }
+  return info;
+#endif
+}
+
+} // namespace LinAlg::backend
@@ -1,8 +1,14 @@
 #include "LinAlg.hpp"
+#include "IO/ChronoTimer.hpp"
 #include "catch2/catch.hpp"
 #include <algorithm>
+#include <cmath>
 #include <complex>
+#include <cstdio>
 #include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 //==============================================================================
 TEST_CASE("LinAlg: Element access, memory layout", "[LinAlg][unit]") {
@@ -479,6 +485,44 @@ TEST_CASE("LinAlg: linear equation <complex<double>>", "[LinAlg][unit]") {
   REQUIRE(LinAlg::equal(x, x_sol));
 }
 
+TEST_CASE("LinAlg: GMRES", "[LinAlg][unit]") {
+  // Non-symmetric, diagonally dominant, test matrix
+  const std::size_t n = 60;
+  LinAlg::Matrix<double> A(n, n);
+  LinAlg::Vector<double> b(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      A(i, j) = i == j ? 4.0 + 0.1 * double(i) :
+                         std::sin(double(3 * i + j)) / double(1 + i + j);
+    }
+    b(i) = std::cos(double(i));
+  }
+  const auto x_exact = solve_Axeqb(A, b);
+  const auto A_x = [&](const std::vector<double> &v) {
+    std::vector<double> Av(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      Av[i] = std::inner_product(A[i], A[i] + n, v.begin(), 0.0);
+    }
+    return Av;
+  };
+  const std::vector<double> bv(b.data(), b.data() + n);
+
+  // With and without restarts
+  for (const int restart : {5, 80}) {
+    std::vector<double> x(n, 0.0);
+    const auto [its, res] = LinAlg::GMRES(A_x, bv, x, 1.0e-12, 200, restart);
+    REQUIRE(res < 1.0e-12);
+    REQUIRE(its < 200);
+    for (std::size_t i = 0; i < n; ++i) {
+      REQUIRE(x[i] == Approx(x_exact(i)).margin(1.0e-12));
+    }
+  }
+
+  // Starting from the solution: no iterations
+  std::vector<double> x(x_exact.data(), x_exact.data() + n);
+  REQUIRE(LinAlg::GMRES(A_x, bv, x, 1.0e-10, 200).first == 0);
+}
+
 //==============================================================================
 // Eigensystems (symmetric/Hermetian)
 TEST_CASE("LinAlg: eigensystems <double>", "[LinAlg][unit]") {
@@ -564,6 +608,103 @@ TEST_CASE("LinAlg: Generalised eigensystems <complex<double>>",
   REQUIRE(std::abs(sum) < 1.0e-12);
 }
 
+// Partial-spectrum eigensystems (by index and by value), compared to full
+TEST_CASE("LinAlg: partial eigensystems", "[LinAlg][unit]") {
+  using namespace std::complex_literals;
+  const std::size_t n = 40;
+
+  // max |Av - eBv| over all returned eigenpairs
+  const auto residual = [](const auto &A, const auto &B, const auto &e,
+                           const auto &v) {
+    double max = 0.0;
+    for (std::size_t k = 0; k < e.size(); ++k) {
+      for (std::size_t i = 0; i < A.rows(); ++i) {
+        std::complex<double> del = 0.0;
+        for (std::size_t j = 0; j < A.cols(); ++j) {
+          del += A(i, j) * v(k, j) - e(k) * B(i, j) * v(k, j);
+        }
+        max = std::max(max, std::abs(del));
+      }
+    }
+    return max;
+  };
+
+  const auto test = [&](auto x) {
+    using T = decltype(x);
+    LinAlg::Matrix<T> A(n, n), B(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j <= i; ++j) {
+        A(i, j) = std::cos(double(i * j) + 0.1 * double(i));
+        B(i, j) = 0.01 * std::sin(double(i + 2 * j));
+        if constexpr (std::is_same_v<T, std::complex<double>>) {
+          A(i, j) += i == j ? 0.0 : 0.3i * std::sin(double(i - j));
+          B(i, j) += i == j ? 0.0 : 0.01i * std::cos(double(i + j));
+        }
+        if constexpr (std::is_same_v<T, std::complex<double>>) {
+          A(j, i) = std::conj(A(i, j));
+          B(j, i) = std::conj(B(i, j));
+        } else {
+          A(j, i) = A(i, j);
+          B(j, i) = B(i, j);
+        }
+      }
+      A(i, i) += double(i);
+      B(i, i) = 1.0;
+    }
+    const auto I = LinAlg::Matrix<T>(n).make_identity();
+
+    const auto [e0, v0] = LinAlg::symmhEigensystem(A);
+    const auto [eg0, vg0] = LinAlg::symmhEigensystem(A, B);
+
+    // lowest few
+    const auto [e1, v1] = LinAlg::symmhEigensystem(A, 5);
+    REQUIRE(e1.size() == 5);
+    REQUIRE(v1.rows() == 5);
+    REQUIRE(v1.cols() == n);
+    // index window, in the middle
+    const auto [e2, v2] =
+        LinAlg::symmhEigensystem(A, LinAlg::EigenRange::index(10, 19));
+    REQUIRE(e2.size() == 10);
+    // value window
+    const auto [e3, v3] = LinAlg::symmhEigensystem(
+        A, LinAlg::EigenRange::value(e0(20) - 1.0e-6, e0(29) + 1.0e-6));
+    REQUIRE(e3.size() == 10);
+    for (std::size_t i = 0; i < 10; ++i) {
+      if (i < 5)
+        REQUIRE(e1(i) == Approx(e0(i)).margin(1.0e-10));
+      REQUIRE(e2(i) == Approx(e0(i + 10)).margin(1.0e-10));
+      REQUIRE(e3(i) == Approx(e0(i + 20)).margin(1.0e-10));
+    }
+    REQUIRE(residual(A, I, e1, v1) < 1.0e-10);
+    REQUIRE(residual(A, I, e2, v2) < 1.0e-10);
+    REQUIRE(residual(A, I, e3, v3) < 1.0e-10);
+
+    // Generalised, with the same (re-used) solver
+    LinAlg::SymmhEigensolver<T> solver;
+    for (int rep = 0; rep < 2; ++rep) {
+      const auto [eg1, vg1] =
+          solver.solve(A, B, LinAlg::EigenRange::index(n - 5, n - 1));
+      REQUIRE(eg1.size() == 5);
+      const auto [eg2, vg2] = solver.solve(
+          A, B, LinAlg::EigenRange::value(eg0(0) - 1.0, eg0(9) + 1.0e-6));
+      REQUIRE(eg2.size() == 10);
+      for (std::size_t i = 0; i < 5; ++i) {
+        REQUIRE(eg1(i) == Approx(eg0(n - 5 + i)).margin(1.0e-10));
+        REQUIRE(eg2(i) == Approx(eg0(i)).margin(1.0e-10));
+      }
+      REQUIRE(residual(A, B, eg1, vg1) < 1.0e-10);
+      REQUIRE(residual(A, B, eg2, vg2) < 1.0e-10);
+    }
+    // Empty window
+    const auto [e4, v4] = LinAlg::symmhEigensystem(
+        A, LinAlg::EigenRange::value(e0(n - 1) + 1.0, e0(n - 1) + 2.0));
+    REQUIRE(e4.size() == 0);
+  };
+
+  test(double{});
+  test(std::complex<double>{});
+}
+
 // Eigensystems (non-symmetric, Real)
 TEST_CASE("LinAlg: non-symmetric eigensystems <double>", "[LinAlg][unit]") {
   const LinAlg::Matrix A{{1.0, -1.0}, {-2.0, 3.0}};
@@ -666,4 +807,107 @@ TEST_CASE("LinAlg: Row and Column Views, complex", "[LinAlg][unit]") {
       REQUIRE(b(i, j) == 4.0 * a(i, j));
     }
   }
-}
\ No newline at end of file
+}
+//==============================================================================
+// Compares the LinAlg backend (see LinAlg::backend) against GSL, for matrix
+// sizes typical of: B-spline basis (~100), Feynman (~250, complex), CI (~1000)
+TEST_CASE("LinAlg: backend benchmark", "[LinAlg][benchmark][.]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "LinAlg: backend benchmark (" << LinAlg::backend::name()
+            << ")\n";
+
+  // Deterministic, well-conditioned, symmetric test matrix
+  const auto make_matrix = [](std::size_t n, auto x) {
+    using T = decltype(x);
+    LinAlg::Matrix<T> a(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < n; ++j) {
+        a(i, j) = T(std::sin(double(i + j) + 0.3 * double(i * j % 7)));
+      }
+      a(i, i) += T(double(n));
+    }
+    return a;
+  };
+
+  const auto time_ms = [](int reps, auto &&f) {
+    IO::ChronoTimer timer;
+    for (int i = 0; i < reps; ++i)
+      f();
+    return timer.reading_ms() / reps;
+  };
+
+  const auto gsl_product = [](const auto &a, const auto &b) {
+    using T = std::remove_cv_t<std::remove_reference_t<decltype(a(0, 0))>>;
+    LinAlg::Matrix<T> c(a.rows(), b.cols());
+    const auto a_gsl = a.as_gsl_view();
+    const auto b_gsl = b.as_gsl_view();
+    auto c_gsl = c.as_gsl_view();
+    if constexpr (std::is_same_v<T, double>) {
+      gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, &a_gsl.matrix,
+                     &b_gsl.matrix, 0.0, &c_gsl.matrix);
+    } else {
+      gsl_blas_zgemm(CblasNoTrans, CblasNoTrans, GSL_COMPLEX_ONE,
+                     &a_gsl.matrix, &b_gsl.matrix, GSL_COMPLEX_ZERO,
+                     &c_gsl.matrix);
+    }
+    return c;
+  };
+
+  const auto gsl_inverse = [](auto a) {
+    auto inv = a;
+    int sLU = 0;
+    auto a_gsl = a.as_gsl_view();
+    auto inv_gsl = inv.as_gsl_view();
+    gsl_permutation *permutn = gsl_permutation_alloc(a.rows());
+    if constexpr (std::is_same_v<decltype(a), LinAlg::Matrix<double>>) {
+      gsl_linalg_LU_decomp(&a_gsl.matrix, permutn, &sLU);
+      gsl_linalg_LU_invert(&a_gsl.matrix, permutn, &inv_gsl.matrix);
+    } else {
+      gsl_linalg_complex_LU_decomp(&a_gsl.matrix, permutn, &sLU);
+      gsl_linalg_complex_LU_invert(&a_gsl.matrix, permutn, &inv_gsl.matrix);
+    }
+    gsl_permutation_free(permutn);
+    return inv;
+  };
+
+  const auto max_del = [](const auto &a, const auto &b) {
+    double max = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+      max = std::max(max, std::abs(a.data()[i] - b.data()[i]));
+    return max;
+  };
+
+  const auto benchmark = [&](const std::string &name, std::size_t n,
+                             auto x, int reps) {
+    const auto a = make_matrix(n, x);
+    const auto b = a.transpose();
+
+    const auto t_gemm = time_ms(reps, [&]() { return a * b; });
+    const auto t_gemm_gsl = time_ms(reps, [&]() { return gsl_product(a, b); });
+    const auto t_inv = time_ms(reps, [&]() { return a.inverse(); });
+    const auto t_inv_gsl = time_ms(reps, [&]() { return gsl_inverse(a); });
+
+    std::cout << name << " (n=" << n << ")\n";
+    printf("  gemm   : %8.2f ms [GSL: %8.2f ms]\n", t_gemm, t_gemm_gsl);
+    printf("  inverse: %8.2f ms [GSL: %8.2f ms]\n", t_inv, t_inv_gsl);
+
+    const auto scale = double(n);
+    REQUIRE(max_del(a * b, gsl_product(a, b)) / (scale * scale) < 1.0e-12);
+    REQUIRE(max_del(a.inverse(), gsl_inverse(a)) * scale < 1.0e-10);
+  };
+
+  benchmark("B-spline basis", 100, double{}, 20);
+  benchmark("Feynman", 250, std::complex<double>{}, 2);
+  benchmark("CI", 1000, double{}, 1);
+
+  // Eigensystems (not compared to GSL, which is not used for these)
+  for (const auto n : {100ul, 1000ul}) {
+    const auto a = make_matrix(n, double{});
+    const auto t_all =
+        time_ms(1, [&]() { return LinAlg::symmhEigensystem(a); });
+    const auto t_some =
+        time_ms(1, [&]() { return LinAlg::symmhEigensystem(a, 10); });
+    printf("Eigensystem (n=%zu): all %8.2f ms, lowest 10: %8.2f ms\n", n,
+           t_all, t_some);
+  }
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "LinAlg/Backend.hpp"
 #include "qip/Vector.hpp" // for std::vector overloads
 #include <array>
 #include <cassert>
@@ -43,8 +43,8 @@ public:
 //==============================================================================
 
 //==============================================================================
-// Returns the determinant. Uses GSL; via LU decomposition. Only works for
-// double/complex<double>
+// Returns the determinant. Via LU decomposition (see LinAlg::backend). Only
+// works for double/complex<double>
 template <typename T>
 T Matrix<T>::determinant() const {
   static_assert(std::is_same_v<T, double> ||
@@ -54,25 +54,12 @@ T Matrix<T>::determinant() const {
   assert(rows() == cols() && "Determinant only defined for square matrix");
   // Make a copy, since this is destructive. (Performs LU decomp)
   auto LU = *this; // will become LU decomposed version
-  int sLU = 0;
-  auto gsl_view = LU.as_gsl_view();
-  gsl_permutation *permutn = gsl_permutation_alloc(rows());
-  if constexpr (std::is_same_v<T, double>) {
-    gsl_linalg_LU_decomp(&gsl_view.matrix, permutn, &sLU);
-    gsl_permutation_free(permutn);
-    return gsl_linalg_LU_det(&gsl_view.matrix, sLU);
-  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
-    gsl_linalg_complex_LU_decomp(&gsl_view.matrix, permutn, &sLU);
-    gsl_permutation_free(permutn);
-    const auto gsl_cmplx = gsl_linalg_complex_LU_det(&gsl_view.matrix, sLU);
-    // Can probably avoid this copy? doesn't really matter.
-    return {GSL_REAL(gsl_cmplx), GSL_IMAG(gsl_cmplx)};
-  }
+  return backend::determinant(rows(), LU.data());
 }
 
 //==============================================================================
-// Inverts the matrix, in place. Uses GSL; via LU decomposition. Only works
-// for double/complex<double>.
+// Inverts the matrix, in place. Via LU decomposition (see LinAlg::backend).
+// Only works for double/complex<double>.
 template <typename T>
 Matrix<T> &Matrix<T>::invert_in_place() {
   static_assert(
@@ -80,23 +67,11 @@ Matrix<T> &Matrix<T>::invert_in_place() {
       "invert only works for Matrix<double> or Matrix<complex<double>>");
 
   assert(rows() == cols() && "Inverse only defined for square matrix");
-  int sLU = 0;
-  // gsl_linalg_LU_decomp(m, permutn, &sLU);
-  // gsl_linalg_LU_invx(m, permutn);
-  // In-place inversion gsl_linalg_LU_invx added sometime after GSL v:2.1
-  // Getafix only has 2.1 installed, so can't use this for now
-  auto LU = *this; // copy! to be LU decomposed
-  auto LU_gsl = LU.as_gsl_view();
-  auto iverse_gsl = this->as_gsl_view();
-  gsl_permutation *permutn = gsl_permutation_alloc(m_rows);
-  if constexpr (std::is_same_v<T, double>) {
-    gsl_linalg_LU_decomp(&LU_gsl.matrix, permutn, &sLU);
-    gsl_linalg_LU_invert(&LU_gsl.matrix, permutn, &iverse_gsl.matrix);
-  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
-    gsl_linalg_complex_LU_decomp(&LU_gsl.matrix, permutn, &sLU);
-    gsl_linalg_complex_LU_invert(&LU_gsl.matrix, permutn, &iverse_gsl.matrix);
+  const auto info = backend::invert(m_rows, data());
+  if (info != 0) {
+    std::cout << "\nWARNING 82 in LinAlg::Matrix::invert_in_place: matrix is "
+                 "singular\n";
   }
-  gsl_permutation_free(permutn);
   return *this;
 }
 
@@ -279,29 +254,11 @@ Matrix<T> &Matrix<T>::mult_elements_by(const Matrix<T> &a) {
 //==============================================================================
 template <typename T>
 [[nodiscard]] Matrix<T> operator*(const Matrix<T> &a, const Matrix<T> &b) {
-  // https://www.gnu.org/software/gsl/doc/html/blas.html
   assert(a.cols() == b.rows() &&
          "Matrices a and b must have correct dimension for multiplication");
   Matrix<T> product(a.rows(), b.cols());
-  const auto a_gsl = a.as_gsl_view();
-  const auto b_gsl = b.as_gsl_view();
-  auto product_gsl = product.as_gsl_view();
-  if constexpr (std::is_same_v<T, double>) {
-    gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, &a_gsl.matrix,
-                   &b_gsl.matrix, 0.0, &product_gsl.matrix);
-  } else if constexpr (std::is_same_v<T, float>) {
-    gsl_blas_sgemm(CblasNoTrans, CblasNoTrans, 1.0f, &a_gsl.matrix,
-                   &b_gsl.matrix, 0.0f, &product_gsl.matrix);
-  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
-    gsl_blas_zgemm(CblasNoTrans, CblasNoTrans, GSL_COMPLEX_ONE, &a_gsl.matrix,
-                   &b_gsl.matrix, GSL_COMPLEX_ZERO, &product_gsl.matrix);
-  } else if constexpr (std::is_same_v<T, std::complex<float>>) {
-    const gsl_complex_float one{1.0f, 0.0f};
-    const gsl_complex_float zero{0.0f, 0.0f};
-    gsl_blas_cgemm(CblasNoTrans, CblasNoTrans, one, &a_gsl.matrix,
-                   &b_gsl.matrix, zero, &product_gsl.matrix);
-  }
-
+  backend::gemm(a.rows(), b.cols(), a.cols(), a.data(), b.data(),
+                product.data());
   return product;
 }
 
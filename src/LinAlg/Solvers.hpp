@@ -1,6 +1,13 @@
 #pragma once
 #include "Matrix.hpp"
 #include "Vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace LinAlg {
 
@@ -14,10 +21,83 @@ Vector<T> solve_Axeqb(Matrix<T> Am, const Vector<T> &b);
 template <typename T>
 std::pair<Vector<double>, Matrix<T>> symmhEigensystem(Matrix<T> A);
 
-//! Solves Av=ev for first N eigenvals/vecs v of symmetric matrix A
+//! Solves Av=ev for first N eigenvals/vecs v of symmetric/Hermetian matrix A.
+//! Returns only these N (i.e., e has N rows, and v is N x A.rows()).
 template <typename T>
 std::pair<Vector<double>, Matrix<T>> symmhEigensystem(Matrix<T> A, int number);
 
+//! Range of eigenvalues to find, for partial-spectrum symmhEigensystem
+struct EigenRange {
+  enum class Type { all, index, value };
+  Type type{Type::all};
+  std::size_t first{0}, last{0};
+  double min{0.0}, max{0.0};
+
+  //! All eigenvalues
+  static EigenRange all() { return {}; }
+  //! Eigenvalues first through last (inclusive; counting from 0, ascending)
+  static EigenRange index(std::size_t first, std::size_t last) {
+    return {Type::index, first, last, 0.0, 0.0};
+  }
+  //! The lowest 'number' eigenvalues
+  static EigenRange lowest(std::size_t number) {
+    return index(0, number == 0 ? 0 : number - 1);
+  }
+  //! All eigenvalues e in the half-open window min < e <= max
+  static EigenRange value(double min, double max) {
+    return {Type::value, 0, 0, min, max};
+  }
+};
+
+/*!
+@brief Partial-spectrum eigensolver for symmetric/Hermetian A (or A,B) that
+keeps its LAPACK workspace between calls.
+@details
+Finds only the eigenpairs in the given EigenRange: by index, or energy window.
+Standard problem (Av=ev) uses the MRRR algorithm (dsyevr/zheevr); generalised
+problem (Av=eBv, B positive definite) uses dsygvx/zhegvx. Workspace is only
+re-queried when the matrix size changes (and only grows), so repeated calls
+(e.g., one per kappa for a spline basis) do not re-allocate it. Returns [e,v],
+as for symmhEigensystem, but e and v have only as many rows as eigenvalues
+found.
+Not thread-safe: use one per thread (as symmhEigensystem does).
+*/
+template <typename T>
+class SymmhEigensolver {
+  static_assert(std::is_same_v<T, double> ||
+                    std::is_same_v<T, std::complex<double>>,
+                "SymmhEigensolver only for double or complex<double>");
+  // Matrix size workspace was last sized for (standard, generalised)
+  std::size_t m_n{0}, m_n_gen{0};
+  std::vector<T> m_work{};
+  std::vector<double> m_rwork{};
+  std::vector<int> m_iwork{};
+  std::vector<int> m_isuppz{}; // also 'ifail' for generalised
+
+public:
+  //! Solves Av = ev, for eigenvalues in range
+  std::pair<Vector<double>, Matrix<T>> solve(Matrix<T> A,
+                                             const EigenRange &range);
+
+  //! Solves Av = eBv, for eigenvalues in range
+  std::pair<Vector<double>, Matrix<T>>
+  solve(Matrix<T> A, Matrix<T> B, const EigenRange &range);
+};
+
+//! Solves Av=ev for eigenvalues in given range (by index, or value) of
+//! symmetric/Hermetian matrix A; see SymmhEigensolver. (EigenRange::all() is
+//! the same as symmhEigensystem(A).)
+template <typename T>
+std::pair<Vector<double>, Matrix<T>> symmhEigensystem(Matrix<T> A,
+                                                      const EigenRange &range);
+
+//! Solves Av=eBv for eigenvalues in given range (by index, or value) of
+//! symmetric/Hermetian matrix pair A,B; see SymmhEigensolver.
+//! (EigenRange::all() is the same as symmhEigensystem(A, B).)
+template <typename T>
+std::pair<Vector<double>, Matrix<T>>
+symmhEigensystem(Matrix<T> A, Matrix<T> B, const EigenRange &range);
+
 //! Solves Av = eBv for eigenvalues e and eigenvectors v of symmetric/Hermetian
 //! matrix pair A,B. Returns [e,v], where v(i,j) is the jth element of the ith
 //! eigenvector corresponding to ith eigenvalue, e(i). e is always real.
@@ -32,6 +112,20 @@ template <typename T>
 std::pair<Vector<std::complex<double>>, Matrix<std::complex<double>>>
 genEigensystem(Matrix<T> A, bool sort);
 
+//! Solves Ax=b for x using restarted GMRES(m), for linear operator A given
+//! only by its action (matrix-free).
+/*! @details A is any callable, std::vector<double> A(const std::vector<double>
+&x), returning A*x. On input, x is the starting guess (must be same size as
+b). Iterates until relative residual |b-Ax|/|b| < tol, or until max_its
+applications of A (excluding those for the residual on each restart). Krylov
+basis of up to 'restart' vectors is stored. Any preconditioning must be built
+into A and b. Returns {iterations, relative residual}.
+*/
+template <typename Function>
+std::pair<int, double> GMRES(const Function &A, const std::vector<double> &b,
+                             std::vector<double> &x, double tol, int max_its,
+                             int restart = 20);
+
 //==============================================================================
 //==============================================================================
 } // namespace LinAlg
@@ -18,9 +18,29 @@ void zhegv_(int *, char *, char *, int *, complex_double *, int *,
             complex_double *, int *, double *, complex_double *, int *,
             double *, int *);
 
-void dsyevx_(char *, char *, char *, int *, double *, int *, double *, double *,
-             int *, int *, double *, int *, double *, double *, int *, double *,
-             int *, int *, int *, int *);
+void dsyevr_(const char *, const char *, const char *, const int *, double *,
+             const int *, const double *, const double *, const int *,
+             const int *, const double *, int *, double *, double *,
+             const int *, int *, double *, const int *, int *, const int *,
+             int *);
+void zheevr_(const char *, const char *, const char *, const int *,
+             std::complex<double> *, const int *, const double *,
+             const double *, const int *, const int *, const double *, int *,
+             double *, std::complex<double> *, const int *, int *,
+             std::complex<double> *, const int *, double *, const int *,
+             int *, const int *, int *);
+void dsygvx_(const int *, const char *, const char *, const char *,
+             const int *, double *, const int *, double *, const int *,
+             const double *, const double *, const int *, const int *,
+             const double *, int *, double *, double *, const int *, double *,
+             const int *, int *, int *, int *);
+void zhegvx_(const int *, const char *, const char *, const char *,
+             const int *, std::complex<double> *, const int *,
+             std::complex<double> *, const int *, const double *,
+             const double *, const int *, const int *, const double *, int *,
+             double *, std::complex<double> *, const int *,
+             std::complex<double> *, const int *, double *, int *, int *,
+             int *);
 }
 
 namespace LinAlg {
@@ -33,26 +53,13 @@ Vector<T> solve_Axeqb(Matrix<T> Am, const Vector<T> &b) {
                     std::is_same_v<T, std::complex<double>>,
                 "solve_Axeqb only available for Matrix<double> or "
                 "Matrix<complex<double>>");
-  assert(Am.rows() == b.size());
+  assert(Am.rows() == b.size() && Am.rows() == Am.cols());
 
-  Vector<T> x(Am.cols());
-
-  auto Am_gsl = Am.as_gsl_view();
-  const auto b_gsl = b.as_gsl_view();
-  auto x_gsl = x.as_gsl_view();
-
-  int sLU = 0;
-  gsl_permutation *Am_perm =
-      gsl_permutation_alloc(std::max(Am.rows(), Am.cols()));
-  if constexpr (std::is_same_v<T, double>) {
-    gsl_linalg_LU_decomp(&Am_gsl.matrix, Am_perm, &sLU);
-    gsl_linalg_LU_solve(&Am_gsl.matrix, Am_perm, &b_gsl.vector, &x_gsl.vector);
-  } else if constexpr (std::is_same_v<T, std::complex<double>>) {
-    gsl_linalg_complex_LU_decomp(&Am_gsl.matrix, Am_perm, &sLU);
-    gsl_linalg_complex_LU_solve(&Am_gsl.matrix, Am_perm, &b_gsl.vector,
-                                &x_gsl.vector);
+  Vector<T> x = b; // copy: overwritten by solution
+  const auto info = backend::solve(Am.rows(), Am.data(), x.data());
+  if (info != 0) {
+    std::cout << "\nWARNING 48 in LinAlg::solve_Axeqb: matrix is singular\n";
   }
-  gsl_permutation_free(Am_perm);
 
   return x;
 }
@@ -116,41 +123,219 @@ std::pair<Vector<double>, Matrix<T>> symmhEigensystem(Matrix<T> A) {
 template <typename T>
 std::pair<Vector<double>, Matrix<T>> symmhEigensystem(Matrix<T> A, int number) {
   assert(A.rows() == A.cols());
-  assert(number < (int)A.rows());
+  assert(number > 0 && number < (int)A.rows());
+  return symmhEigensystem(std::move(A),
+                          EigenRange::lowest(std::size_t(number)));
+}
 
-  // E. values of Hermetian complex matrix are _real_
-  auto eigen_vv = std::make_pair(Vector<double>(A.rows()),
-                                 Matrix<T>(std::size_t(A.rows())));
-  auto &[e_values, e_vectors] = eigen_vv;
+//============================================================================*
+template <typename T>
+std::pair<Vector<double>, Matrix<T>> symmhEigensystem(Matrix<T> A,
+                                                      const EigenRange &range) {
+  if (range.type == EigenRange::Type::all)
+    return symmhEigensystem(std::move(A));
+  static thread_local SymmhEigensolver<T> solver;
+  return solver.solve(std::move(A), range);
+}
 
-  int dim = (int)A.rows();
-  char jobz{'V'};
-  char uplo{'U'};
-  char range{'I'};
-  double vl{0.0};
-  double vu{0.0};
-  int il{1};
-  int iu{number};
-  double abstol{1.0e-12}; //?
+template <typename T>
+std::pair<Vector<double>, Matrix<T>>
+symmhEigensystem(Matrix<T> A, Matrix<T> B, const EigenRange &range) {
+  if (range.type == EigenRange::Type::all)
+    return symmhEigensystem(std::move(A), std::move(B));
+  static thread_local SymmhEigensolver<T> solver;
+  return solver.solve(std::move(A), std::move(B), range);
+}
+
+//============================================================================*
+namespace detail {
+// EigenRange in LAPACK form: range ('A', 'I', 'V'), [vl,vu], [il,iu] (from 1),
+// and maximum number of eigenvalues that will be found
+struct LapackRange {
+  char range;
+  double vl, vu;
+  int il, iu;
+  std::size_t max_m;
+};
+
+inline LapackRange lapack_range(const EigenRange &r, std::size_t n) {
+  if (r.type == EigenRange::Type::index) {
+    assert(r.first <= r.last && r.last < n);
+    return {'I', 0.0, 0.0, int(r.first) + 1, int(r.last) + 1,
+            r.last - r.first + 1};
+  } else if (r.type == EigenRange::Type::value) {
+    assert(r.min < r.max);
+    return {'V', r.min, r.max, 0, 0, n};
+  }
+  return {'A', 0.0, 0.0, 0, 0, n};
+}
+
+// Builds [e,v] from LAPACK output: first m of w, and m eigenvectors stored
+// contiguously in z. LAPACK saw the (row-major) transpose, A^T = A*, so
+// complex eigenvectors are conjugated
+template <typename T>
+std::pair<Vector<double>, Matrix<T>>
+eigen_pair(std::size_t m, std::size_t n, std::vector<double> &&w,
+           std::vector<T> &&z) {
+  w.resize(m);
+  z.resize(m * n);
+  auto eigen_vv = std::make_pair(Vector<double>(std::move(w)),
+                                 Matrix<T>(m, n, std::move(z)));
+  if constexpr (std::is_same_v<T, std::complex<double>>) {
+    eigen_vv.second.conj_in_place();
+  }
+  return eigen_vv;
+}
+} // namespace detail
+
+//============================================================================*
+template <typename T>
+std::pair<Vector<double>, Matrix<T>>
+SymmhEigensolver<T>::solve(Matrix<T> A, const EigenRange &range) {
+  assert(A.rows() == A.cols());
+  const auto n = A.rows();
+  if (n == 0)
+    return {};
+  const auto [rng, vl, vu, il, iu, max_m] = detail::lapack_range(range, n);
+
+  const int dim = int(n);
+  const char jobz{'V'};
+  const char uplo{'U'};
+  const double abstol{0.0}; // nb: not used by MRRR
   int m{0};
   int info{0};
+  std::vector<double> w(n);
+  std::vector<T> z(n * max_m);
+
+  // Workspace query: only when size changes
+  if (n != m_n) {
+    T work_size{0};
+    double rwork_size{0.0};
+    int iwork_size{0};
+    const int query{-1};
+    if constexpr (std::is_same_v<T, double>) {
+      dsyevr_(&jobz, &rng, &uplo, &dim, A.data(), &dim, &vl, &vu, &il, &iu,
+              &abstol, &m, w.data(), z.data(), &dim, m_isuppz.data(),
+              &work_size, &query, &iwork_size, &query, &info);
+    } else {
+      zheevr_(&jobz, &rng, &uplo, &dim, A.data(), &dim, &vl, &vu, &il, &iu,
+              &abstol, &m, w.data(), z.data(), &dim, m_isuppz.data(),
+              &work_size, &query, &rwork_size, &query, &iwork_size, &query,
+              &info);
+    }
+    const auto grow = [](auto &v, std::size_t size) {
+      if (v.size() < size)
+        v.resize(size);
+    };
+    grow(m_work, std::size_t(std::real(work_size)));
+    grow(m_rwork, std::size_t(rwork_size));
+    grow(m_iwork, std::size_t(iwork_size));
+    grow(m_isuppz, 2 * n);
+    m_n = n;
+  }
 
-  std::vector<T> work(8 * A.rows());
-  std::vector<int> iwork(5 * A.rows());
-  std::vector<int> ifail(A.rows());
-  int workspace_size = (int)work.size();
+  const int lwork = int(m_work.size());
+  const int lrwork = int(m_rwork.size());
+  const int liwork = int(m_iwork.size());
+  if constexpr (std::is_same_v<T, double>) {
+    dsyevr_(&jobz, &rng, &uplo, &dim, A.data(), &dim, &vl, &vu, &il, &iu,
+            &abstol, &m, w.data(), z.data(), &dim, m_isuppz.data(),
+            m_work.data(), &lwork, m_iwork.data(), &liwork, &info);
+  } else {
+    zheevr_(&jobz, &rng, &uplo, &dim, A.data(), &dim, &vl, &vu, &il, &iu,
+            &abstol, &m, w.data(), z.data(), &dim, m_isuppz.data(),
+            m_work.data(), &lwork, m_rwork.data(), &lrwork, m_iwork.data(),
+            &liwork, &info);
+  }
+
+  if (info != 0) {
+    std::cerr << "\nError 135: symmhEigensystem (dsyevr/zheevr) " << info
+              << " " << dim << std::endl;
+    if (info < 0) {
+      std::cerr << "The " << -info << "-th argument had an illegal value\n";
+    }
+    m = 0;
+  }
+
+  return detail::eigen_pair(std::size_t(m), n, std::move(w), std::move(z));
+}
+
+//============================================================================*
+template <typename T>
+std::pair<Vector<double>, Matrix<T>>
+SymmhEigensolver<T>::solve(Matrix<T> A, Matrix<T> B, const EigenRange &range) {
+  assert(A.rows() == A.cols());
+  assert(B.rows() == B.cols());
+  assert(A.rows() == B.rows());
+  const auto n = A.rows();
+  if (n == 0)
+    return {};
+  const auto [rng, vl, vu, il, iu, max_m] = detail::lapack_range(range, n);
+
+  const int itype{1};
+  const int dim = int(n);
+  const char jobz{'V'};
+  const char uplo{'U'};
+  // Most accurate (see LAPACK docs): 2*dlamch('S')
+  const double abstol{2.0 * std::numeric_limits<double>::min()};
+  int m{0};
+  int info{0};
+  std::vector<double> w(n);
+  std::vector<T> z(n * max_m);
+
+  const auto grow = [](auto &v, std::size_t size) {
+    if (v.size() < size)
+      v.resize(size);
+  };
+
+  // Workspace query: only when size changes
+  if (n != m_n_gen) {
+    T work_size{0};
+    const int query{-1};
+    if constexpr (std::is_same_v<T, double>) {
+      dsygvx_(&itype, &jobz, &rng, &uplo, &dim, A.data(), &dim, B.data(), &dim,
+              &vl, &vu, &il, &iu, &abstol, &m, w.data(), z.data(), &dim,
+              &work_size, &query, m_iwork.data(), m_isuppz.data(), &info);
+    } else {
+      zhegvx_(&itype, &jobz, &rng, &uplo, &dim, A.data(), &dim, B.data(), &dim,
+              &vl, &vu, &il, &iu, &abstol, &m, w.data(), z.data(), &dim,
+              &work_size, &query, m_rwork.data(), m_iwork.data(),
+              m_isuppz.data(), &info);
+    }
+    grow(m_work, std::max(std::size_t(std::real(work_size)), 8 * n));
+    grow(m_rwork, 7 * n);
+    grow(m_iwork, 5 * n);
+    grow(m_isuppz, 2 * n);
+    m_n_gen = n;
+  }
 
-  // For double (symmetric real) matrix
-  dsyevx_(&jobz, &range, &uplo, &dim, A.data(), &dim, &vl, &vu, &il, &iu,
-          &abstol, &m, e_values.data(), e_vectors.data(), &dim, work.data(),
-          &workspace_size, iwork.data(), ifail.data(), &info);
+  const int lwork = int(m_work.size());
+  if constexpr (std::is_same_v<T, double>) {
+    dsygvx_(&itype, &jobz, &rng, &uplo, &dim, A.data(), &dim, B.data(), &dim,
+            &vl, &vu, &il, &iu, &abstol, &m, w.data(), z.data(), &dim,
+            m_work.data(), &lwork, m_iwork.data(), m_isuppz.data(), &info);
+  } else {
+    zhegvx_(&itype, &jobz, &rng, &uplo, &dim, A.data(), &dim, B.data(), &dim,
+            &vl, &vu, &il, &iu, &abstol, &m, w.data(), z.data(), &dim,
+            m_work.data(), &lwork, m_rwork.data(), m_iwork.data(),
+            m_isuppz.data(), &info);
+  }
 
   if (info != 0) {
-    std::cerr << "\nError 135: symmhEigensystem " << info << " " << dim << " "
-              << std::endl;
+    std::cerr << "\nError 254: symmhEigensystem (dsygvx/zhegvx) " << info
+              << " " << dim << std::endl;
+    if (info < 0) {
+      std::cerr << "The " << -info << "-th argument had an illegal value\n";
+    } else if (info <= dim) {
+      std::cerr << info << " eigenvectors failed to converge\n";
+    } else {
+      std::cerr << "The leading minor of order " << info - dim
+                << " of B is not positive definite\n";
+      m = 0;
+    }
   }
 
-  return eigen_vv;
+  return detail::eigen_pair(std::size_t(m), n, std::move(w), std::move(z));
 }
 
 //==============================================================================
@@ -256,4 +441,110 @@ genEigensystem(Matrix<T> A, bool sort) {
   return eigen_vv;
 }
 
+//==============================================================================
+template <typename Function>
+std::pair<int, double> GMRES(const Function &A, const std::vector<double> &b,
+                             std::vector<double> &x, double tol, int max_its,
+                             int restart) {
+  assert(x.size() == b.size() && restart > 0);
+  const auto n = b.size();
+  const auto m = std::size_t(restart);
+
+  const auto dot = [n](const std::vector<double> &u,
+                       const std::vector<double> &v) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += u[i] * v[i];
+    }
+    return sum;
+  };
+
+  const auto b_norm = std::sqrt(dot(b, b));
+  if (b_norm == 0.0) {
+    std::fill(x.begin(), x.end(), 0.0);
+    return {0, 0.0};
+  }
+
+  // Krylov basis, Hessenberg matrix (reduced to triangular by Givens
+  // rotations as we go), rotations, and rhs of least-squares problem
+  std::vector<std::vector<double>> V(m + 1);
+  Matrix<double> H(m + 1, m);
+  std::vector<double> cs(m), sn(m), g(m + 1);
+
+  int its = 0;
+  double rel_res = 1.0;
+  while (true) {
+    // residual, r = b - A*x
+    V[0] = A(x);
+    for (std::size_t i = 0; i < n; ++i) {
+      V[0][i] = b[i] - V[0][i];
+    }
+    const auto beta = std::sqrt(dot(V[0], V[0]));
+    rel_res = beta / b_norm;
+    if (rel_res < tol || its >= max_its)
+      break;
+    for (auto &v : V[0]) {
+      v /= beta;
+    }
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+
+    std::size_t j = 0;
+    while (j < m && its < max_its && rel_res >= tol) {
+      // Arnoldi, modified Gram-Schmidt
+      V[j + 1] = A(V[j]);
+      ++its;
+      auto &w = V[j + 1];
+      for (std::size_t i = 0; i <= j; ++i) {
+        H(i, j) = dot(w, V[i]);
+        for (std::size_t k = 0; k < n; ++k) {
+          w[k] -= H(i, j) * V[i][k];
+        }
+      }
+      H(j + 1, j) = std::sqrt(dot(w, w));
+      if (H(j + 1, j) != 0.0) {
+        for (auto &wk : w) {
+          wk /= H(j + 1, j);
+        }
+      }
+
+      // apply previous rotations to new column, then form new rotation
+      for (std::size_t i = 0; i < j; ++i) {
+        const auto tmp = cs[i] * H(i, j) + sn[i] * H(i + 1, j);
+        H(i + 1, j) = -sn[i] * H(i, j) + cs[i] * H(i + 1, j);
+        H(i, j) = tmp;
+      }
+      const auto d = std::hypot(H(j, j), H(j + 1, j));
+      cs[j] = H(j, j) / d;
+      sn[j] = H(j + 1, j) / d;
+      H(j, j) = d;
+      H(j + 1, j) = 0.0;
+      g[j + 1] = -sn[j] * g[j];
+      g[j] = cs[j] * g[j];
+
+      rel_res = std::abs(g[j + 1]) / b_norm;
+      ++j;
+    }
+
+    // Solve triangular system H*y = g, and update x += V*y
+    std::vector<double> y(j);
+    for (auto i = j; i-- > 0;) {
+      y[i] = g[i];
+      for (auto k = i + 1; k < j; ++k) {
+        y[i] -= H(i, k) * y[k];
+      }
+      y[i] /= H(i, i);
+    }
+    for (std::size_t i = 0; i < j; ++i) {
+      for (std::size_t k = 0; k < n; ++k) {
+        x[k] += y[i] * V[i][k];
+      }
+    }
+    if (rel_res < tol || its >= max_its)
+      break;
+  }
+
+  return {its, rel_res};
+}
+
 } // namespace LinAlg
@@ -94,28 +94,9 @@ public:
   //! Matrix*Vector multiplication: v_i = sum_j A_ij*B_j
   [[nodiscard]] friend Vector<T> operator*(const Matrix<T> &a,
                                            const Vector<T> &b) {
-    // https://www.gnu.org/software/gsl/doc/html/blas.html
     assert(a.cols() == b.rows());
-    Vector<T> product(b.rows());
-    const auto a_gsl = a.as_gsl_view();
-    const auto b_gsl = b.as_gsl_view();
-    auto product_gsl = product.as_gsl_view();
-    if constexpr (std::is_same_v<T, double>) {
-      gsl_blas_dgemv(CblasNoTrans, 1.0, &a_gsl.matrix, &b_gsl.vector, 0.0,
-                     &product_gsl.vector);
-    } else if constexpr (std::is_same_v<T, float>) {
-      gsl_blas_sgemv(CblasNoTrans, 1.0f, &a_gsl.matrix, &b_gsl.vector, 0.0f,
-                     &product_gsl.vector);
-    } else if constexpr (std::is_same_v<T, std::complex<double>>) {
-      gsl_blas_zgemv(CblasNoTrans, GSL_COMPLEX_ONE, &a_gsl.matrix,
-                     &b_gsl.vector, GSL_COMPLEX_ZERO, &product_gsl.vector);
-    } else if constexpr (std::is_same_v<T, std::complex<float>>) {
-      const gsl_complex_float one{1.0f, 0.0f};
-      const gsl_complex_float zero{0.0f, 0.0f};
-      gsl_blas_cgemv(CblasNoTrans, one, &a_gsl.matrix, &b_gsl.vector, zero,
-                     &product_gsl.vector);
-    }
-
+    Vector<T> product(a.rows());
+    backend::gemv(a.rows(), a.cols(), a.data(), b.data(), product.data());
     return product;
   }
 
@@ -75,64 +75,70 @@ GMatrix Goldstone::Sigma_direct(int kappa_v, double en_v,
   if (holes.empty() || excited.empty())
     return Sd;
 
-#pragma omp parallel for collapse(2)
-  for (auto ia = 0ul; ia < holes.size(); ia++) {
-    for (auto in = 0ul; in < excited.size(); in++) {
-      const auto &a = holes[ia];
-      const auto &n = excited[in];
-      if (n_max_core > 0 && a.n() > n_max_core)
-        continue;
-
-      GMatrix Sd_an{m_i0, m_stride, m_subgrid_points, m_include_G, m_grid};
+#pragma omp parallel
+  {
+    // Each thread accumulates into its own matrix, and re-uses the same Qkv
+    // buffer for every term: avoids allocations inside the loops
+    GMatrix Sd_thread{m_i0, m_stride, m_subgrid_points, m_include_G, m_grid};
+    DiracSpinor Qkv{0, kappa_v, m_grid};
+
+#pragma omp for collapse(2)
+    for (auto ia = 0ul; ia < holes.size(); ia++) {
+      for (auto in = 0ul; in < excited.size(); in++) {
+        const auto &a = holes[ia];
+        const auto &n = excited[in];
+        if (n_max_core > 0 && a.n() > n_max_core)
+          continue;
 
-      const auto [kmin_nb, kmax_nb] = Coulomb::k_minmax_Ck(n, a);
-      for (int k = kmin_nb; k <= kmax_nb; k += 2) {
+        const auto [kmin_nb, kmax_nb] = Coulomb::k_minmax_Ck(n, a);
+        for (int k = kmin_nb; k <= kmax_nb; k += 2) {
 
-        const auto f_kkjj = (2 * k + 1) * (tjv + 1);
+          const auto f_kkjj = (2 * k + 1) * (tjv + 1);
 
-        // Effective screening parameter:
-        const auto fk = get_k(k, fks);     // screening
-        const auto etak = get_k(k, etaks); // hole-particle
-        if (fk == 0.0 || etak == 0.0)
-          continue;
-
-        // Diagram (a) [direct]
-        for (const auto &m : excited) {
-          if (!Angular::Ck_kk_SR(k, kappa_v, m.kappa()))
+          // Effective screening parameter:
+          const auto fk = get_k(k, fks);     // screening
+          const auto etak = get_k(k, etaks); // hole-particle
+          if (fk == 0.0 || etak == 0.0)
             continue;
-          const auto Qkv = m_Yeh.Qkv_bcd(k, kappa_v, a, m, n);
-          const auto dele = en_v + a.en() - m.en() - n.en();
-          const auto factor = etak * fk / (f_kkjj * dele);
-          Sd_an.add(Qkv, Qkv, factor);
-
-          if (m_Br) {
-            const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, a, m, n);
-            Sd_an.add(Bkv, Qkv, factor);
-          }
-        }
 
-        // Diagram (c) [direct]
-        for (const auto &b : holes) {
-          if (!Angular::Ck_kk_SR(k, kappa_v, b.kappa()))
-            continue;
-          const auto Qkv = m_Yeh.Qkv_bcd(k, kappa_v, n, b, a);
-          const auto dele = en_v + n.en() - b.en() - a.en();
-          const auto factor = etak * fk / (f_kkjj * dele);
-          Sd_an.add(Qkv, Qkv, factor);
-
-          if (m_Br) {
-            const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, n, b, a);
-            Sd_an.add(Bkv, Qkv, factor);
+          // Diagram (a) [direct]
+          for (const auto &m : excited) {
+            if (!Angular::Ck_kk_SR(k, kappa_v, m.kappa()))
+              continue;
+            m_Yeh.Qkv_bcd(&Qkv, k, a, m, n);
+            const auto dele = en_v + a.en() - m.en() - n.en();
+            const auto factor = etak * fk / (f_kkjj * dele);
+            Sd_thread.add(Qkv, Qkv, factor);
+
+            if (m_Br) {
+              const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, a, m, n);
+              Sd_thread.add(Bkv, Qkv, factor);
+            }
           }
-        } // b
 
-      } // k
+          // Diagram (c) [direct]
+          for (const auto &b : holes) {
+            if (!Angular::Ck_kk_SR(k, kappa_v, b.kappa()))
+              continue;
+            m_Yeh.Qkv_bcd(&Qkv, k, n, b, a);
+            const auto dele = en_v + n.en() - b.en() - a.en();
+            const auto factor = etak * fk / (f_kkjj * dele);
+            Sd_thread.add(Qkv, Qkv, factor);
 
-#pragma omp critical(sum_Sd)
-      { Sd += Sd_an; }
+            if (m_Br) {
+              const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, n, b, a);
+              Sd_thread.add(Bkv, Qkv, factor);
+            }
+          } // b
 
-    } // n
-  }   // a
+        } // k
+
+      } // n
+    }   // a
+
+#pragma omp critical(sum_Sd)
+    { Sd += Sd_thread; }
+  }
 
   return Sd.drj_in_place();
 }
@@ -160,67 +166,74 @@ GMatrix Goldstone::Sigma_exchange(int kappa_v, double en_v,
   if (holes.empty() || excited.empty())
     return Sx;
 
-#pragma omp parallel for collapse(2)
-  for (auto ia = 0ul; ia < holes.size(); ia++) {
-    for (auto in = 0ul; in < excited.size(); in++) {
-      const auto &a = holes[ia];
-      const auto &n = excited[in];
+#pragma omp parallel
+  {
+    // Each thread accumulates into its own matrix, and re-uses the same
+    // Qkv/Pkv buffers for every term: avoids allocations inside the loops
+    GMatrix Sx_thread{m_i0, m_stride, m_subgrid_points, m_include_G, m_grid};
+    DiracSpinor Qkv{0, kappa_v, m_grid};
+    DiracSpinor Pkv{0, kappa_v, m_grid};
 
-      GMatrix Sx_an{m_i0, m_stride, m_subgrid_points, m_include_G, m_grid};
+#pragma omp for collapse(2)
+    for (auto ia = 0ul; ia < holes.size(); ia++) {
+      for (auto in = 0ul; in < excited.size(); in++) {
+        const auto &a = holes[ia];
+        const auto &n = excited[in];
 
-      const auto [kmin_nb, kmax_nb] = Coulomb::k_minmax_Ck(n, a);
-      for (int k = kmin_nb; k <= kmax_nb; k += 2) {
+        const auto [kmin_nb, kmax_nb] = Coulomb::k_minmax_Ck(n, a);
+        for (int k = kmin_nb; k <= kmax_nb; k += 2) {
 
-        const auto f_kkjj = (2 * k + 1) * (tjv + 1);
-
-        // Effective screening parameter:
-        const auto fk = get_k(k, fks); // screening
-        if (fk == 0.0)
-          continue;
+          const auto f_kkjj = (2 * k + 1) * (tjv + 1);
 
-        // Diagram (b) [exchange]
-        for (const auto &m : excited) {
-          if (!Angular::Ck_kk_SR(k, kappa_v, m.kappa()))
+          // Effective screening parameter:
+          const auto fk = get_k(k, fks); // screening
+          if (fk == 0.0)
             continue;
-          const auto Qkv = m_Yeh.Qkv_bcd(k, kappa_v, a, m, n);
-          // screen both Coulomb lines??
-          // const auto Pkv = m_Yeh.Pkv_bcd(k, kappa_v, a, m, n, fks);
-          const auto Pkv = m_Yeh.Pkv_bcd(k, kappa_v, a, m, n);
-          const auto dele = en_v + a.en() - m.en() - n.en();
-          const auto factor = fk / (f_kkjj * dele);
-          Sx_an.add(Qkv, Pkv, factor);
-
-          if (m_Br) {
-            const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, a, m, n);
-            Sx_an.add(Bkv, Pkv, factor);
-          }
-        }
 
-        // Diagram (d) [exchange]
-        for (const auto &b : holes) {
-          if (!Angular::Ck_kk_SR(k, kappa_v, b.kappa()))
-            continue;
-          const auto Qkv = m_Yeh.Qkv_bcd(k, kappa_v, n, b, a);
-          // screen both Coulomb lines??
-          // const auto Pkv = m_Yeh.Pkv_bcd(k, kappa_v, n, b, a, fks);
-          const auto Pkv = m_Yeh.Pkv_bcd(k, kappa_v, n, b, a);
-          const auto dele = en_v + n.en() - b.en() - a.en();
-          const auto factor = fk / (f_kkjj * dele);
-          Sx_an.add(Qkv, Pkv, factor);
-
-          if (m_Br) {
-            const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, n, b, a);
-            Sx_an.add(Bkv, Pkv, factor);
+          // Diagram (b) [exchange]
+          for (const auto &m : excited) {
+            if (!Angular::Ck_kk_SR(k, kappa_v, m.kappa()))
+              continue;
+            m_Yeh.Qkv_bcd(&Qkv, k, a, m, n);
+            // screen both Coulomb lines??
+            // m_Yeh.Pkv_bcd(&Pkv, k, a, m, n, fks);
+            m_Yeh.Pkv_bcd(&Pkv, k, a, m, n);
+            const auto dele = en_v + a.en() - m.en() - n.en();
+            const auto factor = fk / (f_kkjj * dele);
+            Sx_thread.add(Qkv, Pkv, factor);
+
+            if (m_Br) {
+              const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, a, m, n);
+              Sx_thread.add(Bkv, Pkv, factor);
+            }
           }
-        } // b
 
-      } // k
+          // Diagram (d) [exchange]
+          for (const auto &b : holes) {
+            if (!Angular::Ck_kk_SR(k, kappa_v, b.kappa()))
+              continue;
+            m_Yeh.Qkv_bcd(&Qkv, k, n, b, a);
+            // screen both Coulomb lines??
+            // m_Yeh.Pkv_bcd(&Pkv, k, n, b, a, fks);
+            m_Yeh.Pkv_bcd(&Pkv, k, n, b, a);
+            const auto dele = en_v + n.en() - b.en() - a.en();
+            const auto factor = fk / (f_kkjj * dele);
+            Sx_thread.add(Qkv, Pkv, factor);
+
+            if (m_Br) {
+              const auto Bkv = m_Br->Bkv_bcd(k, kappa_v, n, b, a);
+              Sx_thread.add(Bkv, Pkv, factor);
+            }
+          } // b
+
+        } // k
+
+      } // n
+    }   // a
 
 #pragma omp critical(sum_Sx)
-      { Sx += Sx_an; }
-
-    } // n
-  }   // a
+    { Sx += Sx_thread; }
+  }
 
   // std::cin.get();
 
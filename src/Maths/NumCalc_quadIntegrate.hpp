@@ -2,6 +2,7 @@
 #include "Maths/Grid.hpp"
 #include "Maths/NumCalc_coeficients.hpp"
 #include "qip/Vector.hpp"
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <functional>
@@ -54,6 +55,24 @@ inline double integrate(const double dt, std::size_t beg, std::size_t end,
   return (Rint_mid + dq_inv * Rint_ends) * dt;
 }
 
+//! Quadrature weights used by integrate(), for integration from 0 to end-1,
+//! on a grid of max_grid points: integrate(dt, 0, end, f...) = dt *
+//! sum_i w[i]*(f...)[i]. Returned vector has size end.
+inline std::vector<double> integrate_weights(std::size_t end,
+                                             std::size_t max_grid) {
+  if (end == 0)
+    end = max_grid;
+  const auto end_mid = std::min(max_grid - Nquad, end);
+  std::vector<double> w(end, 1.0);
+  for (std::size_t i = 0; i < Nquad; ++i) {
+    w[i] = dq_inv * cq[i];
+  }
+  for (auto i = end_mid; i < end; ++i) {
+    w[i] = dq_inv * cq[end_mid + Nquad - i - 1];
+  }
+  return w;
+}
+
 //==============================================================================
 template <typename T>
 inline std::vector<T> derivative(const std::vector<T> &f,
@@ -92,4 +92,44 @@ std::vector<T> fillBesselVec_kr(const int l, const double k,
   return Jl_vec;
 }
 
+//! Fills j_l(kr) for all l = 0,1,...,max_l at once, for first num_points of
+//! rvec (all if num_points=0). Returns {l}{r}.
+/*! @details Uses upward recurrence, j_{l+1} = (2l+1)/x j_l - j_{l-1}, from
+j_0 and j_1 (one sin and cos per point), where this is stable (x > max_l), and
+GSL otherwise (small x). Much faster than calling GSL for each l and r.
+*/
+template <typename T>
+std::vector<std::vector<T>> fillBesselVecs_kr(int max_l, double k,
+                                              const std::vector<T> &rvec,
+                                              std::size_t num_points = 0) {
+  if (num_points == 0 || num_points > rvec.size())
+    num_points = rvec.size();
+  std::vector<std::vector<T>> jl(std::size_t(max_l + 1),
+                                 std::vector<T>(num_points));
+  for (std::size_t i = 0; i < num_points; ++i) {
+    const auto x = k * double(rvec[i]);
+    if (x <= double(max_l) || x < 1.0) {
+      for (int l = 0; l <= max_l; ++l) {
+        jl[std::size_t(l)][i] = exactGSL_JL(l, T(x));
+      }
+      continue;
+    }
+    const auto s = std::sin(x);
+    const auto c = std::cos(x);
+    double jm = s / x;
+    jl[0][i] = T(jm);
+    if (max_l == 0)
+      continue;
+    double j = s / (x * x) - c / x;
+    jl[1][i] = T(j);
+    for (int l = 1; l < max_l; ++l) {
+      const auto jp = double(2 * l + 1) / x * j - jm;
+      jm = j;
+      j = jp;
+      jl[std::size_t(l + 1)][i] = T(j);
+    }
+  }
+  return jl;
+}
+
 } // namespace SphericalBessel
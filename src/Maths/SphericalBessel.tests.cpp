@@ -26,4 +26,23 @@ TEST_CASE("Maths::SphericalBessel", "[jL][unit]") {
       }
     }
   }
-}
\ No newline at end of file
+
+  // All L at once, using recurrence where stable
+  for (const auto k : {0.01, 0.15, 3.0, 80.0}) {
+    const int max_L = 12;
+    const auto jls = SphericalBessel::fillBesselVecs_kr(max_L, k, r_list);
+    REQUIRE(jls.size() == max_L + 1);
+    for (int L = 0; L <= max_L; ++L) {
+      const auto &jl = jls.at(std::size_t(L));
+      REQUIRE(jl.size() == r_list.size());
+      for (auto i = 0ul; i < r_list.size(); ++i) {
+        REQUIRE(jl.at(i) ==
+                Approx(SphericalBessel::exactGSL_JL(L, k * r_list.at(i)))
+                    .margin(1.0e-12));
+      }
+    }
+  }
+  // Only first num_points
+  REQUIRE(SphericalBessel::fillBesselVecs_kr(2, 1.0, r_list, 10).at(2).size() ==
+          10);
+}
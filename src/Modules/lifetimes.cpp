@@ -8,6 +8,7 @@
 #include "Physics/PhysConst_constants.hpp" // For GHz unit conversion
 #include "Wavefunction/Wavefunction.hpp"
 #include "qip/Maths.hpp"
+#include <fstream>
 
 //! E1 partial rate: d = <f||E1||i>, gi = [Ji] = 2Ji+1, w = Ef - Ei
 double gamma_E1(double d, double w, double gi) {
@@ -48,7 +49,9 @@ void lifetimes(const IO::InputBlock &input, const Wavefunction &wf) {
                    "from scratch, ortherwise will read/write to Qkfile. "
                    "Note: QkFile assumes spline-legs! [blank]"},
        {"n_minmax", "List: minimum core n, maximum excited n to "
-                    "include for SR+N [2,30]"}});
+                    "include for SR+N [2,30]"},
+       {"table", "Filename: if given, all matrix elements are also written "
+                 "to this file as a plain-text table [blank]"}});
   // If we are just requesting 'help', don't run module:
   if (input.has_option("help")) {
     return;
@@ -61,6 +64,7 @@ void lifetimes(const IO::InputBlock &input, const Wavefunction &wf) {
   const auto do_SRN = input.get("SRN", false);
   const auto n_min_max = input.get("n_minmax", std::vector<int>{2, 30});
   const auto Qkfile = input.get("Qk_file", std::string{});
+  const auto table_fname = input.get("table", std::string{});
   assert(n_min_max.size() >= 2);
 
   if (rpaQ && wf.basis().empty() && (do_E2 || do_M1)) {
@@ -156,6 +160,14 @@ void lifetimes(const IO::InputBlock &input, const Wavefunction &wf) {
     std::cout << "\n";
   }
 
+  if (!table_fname.empty()) {
+    std::ofstream table_file(table_fname);
+    write_table(table_file, e1s, "E1");
+    write_table(table_file, e2s, "E2");
+    write_table(table_file, m1s, "M1");
+    std::cout << "Matrix elements written to: " << table_fname << "\n";
+  }
+
   auto finder = [](const auto &ta, const auto &tb) {
     const auto a = ta.shortSymbol();
     const auto b = tb.shortSymbol();
@@ -422,9 +422,6 @@ void dynamicPolarisability(const IO::InputBlock &input,
     const auto w_initial = rpa_omegaQ ? w_list.front() : 0.0;
     dVE1.solve_core(w_initial);
   }
-  // if not rpa_omegaQ, then dV included in meTable
-  auto *const dVptr = rpa_omegaQ ? &dVE1 : nullptr;
-
   // static (w=0) core part.
   const auto ac0 = core_omegaQ ?
                        0.0 :
@@ -513,57 +510,76 @@ void dynamicPolarisability(const IO::InputBlock &input,
   std::cout << title << "\n";
   ofile << title << "\n";
   o2file << title << "\n";
-  int count = 0;
-  for (auto ww : w_list) {
-    const auto lambda = (2.0 * M_PI * PhysConst::c / ww) * PhysConst::aB_nm;
-
-    // if <20, print all; otherwise, first + last + every 10th
-    count++;
-    const auto print =
-        w_list.size() < 20 ?
-            true :
-            (ww == w_list.front() || ww == w_list.back() || (count % 20 == 0));
-
-    if (rpaQ && rpa_omegaQ) {
-      if (dVE1.get_eps() > 1.0e-2) {
-        // if tdhf didn't converge well last time, start from scratch
-        // (otherwise, start from where we left off, since much faster)
-        dVE1.clear();
-        dVE1.solve_core(ww, 128, false);
-      } else {
-        dVE1.solve_core(ww, 5, false);
-      }
-    }
+  // Calculate a(w) for each frequency first (solving RPA for each), then
+  // write out in order
+  struct AlphaW {
+    double ac{0.0};
+    std::vector<double> avs{};
+    std::vector<double> a2s{};
+    double eps{0.0};
+  };
+  std::vector<AlphaW> alphas(w_list.size());
+
+  const auto calc_alpha = [&](const ExternalField::TDHF &dV, std::size_t iw) {
+    const auto ww = w_list.at(iw);
+    // if not rpa_omegaQ, then dV included in meTable
+    const ExternalField::CorePolarisation *const dVp =
+        rpa_omegaQ ? &dV : nullptr;
+    auto &[ac, avs, a2s, eps] = alphas.at(iw);
     // MS method is fine for the core, and _much_ faster, and core contributes
     // negligably..so fine.
-    const auto ac =
-        !core_omegaQ ?
-            ac0 :
-            (method == "MS" ?
-                 alphaD::core_tdhf(wf.core(), he1, dVE1, ww, wf.Sigma()) :
-                 alphaD::core_sos(wf.core(), spectrum, he1, dVptr, ww, &metab));
-
-    if (print)
-      printf("%9.2e %9.2e %9.2e ", ww, lambda, ac);
-    ofile << ww << " " << lambda << " " << ac << " ";
-    // no core contrib to a2, but write zero so columns align
-    o2file << ww << " " << lambda << " " << 0.0 << " ";
-    std::vector<double> avs(wf.valence().size());
-    std::vector<double> a2s(wf.valence().size());
+    ac = !core_omegaQ ?
+             ac0 :
+             (method == "MS" ?
+                  alphaD::core_tdhf(wf.core(), he1, dV, ww, wf.Sigma()) :
+                  alphaD::core_sos(wf.core(), spectrum, he1, dVp, ww, &metab));
+    avs.resize(wf.valence().size());
+    a2s.resize(wf.valence().size());
 #pragma omp parallel for if (method == "MS")
     for (auto iv = 0ul; iv < wf.valence().size(); ++iv) {
       const auto &Fv = wf.valence().at(iv);
-      const auto av =
+      avs.at(iv) =
           method == "MS" ?
-              ac + alphaD::valence_tdhf(Fv, he1, dVE1, ww, wf.Sigma()) :
-              ac + alphaD::valence_sos(Fv, spectrum, he1, dVptr, ww, &metab);
-      avs.at(iv) = av;
+              ac + alphaD::valence_tdhf(Fv, he1, dV, ww, wf.Sigma()) :
+              ac + alphaD::valence_sos(Fv, spectrum, he1, dVp, ww, &metab);
       if (do_tensor) {
-        const auto a2 =
-            alphaD::tensor2_sos(Fv, spectrum, he1, dVptr, ww, &metab);
-        a2s.at(iv) = a2;
+        a2s.at(iv) = alphaD::tensor2_sos(Fv, spectrum, he1, dVp, ww, &metab);
       }
     }
+    eps = dV.get_eps();
+  };
+
+  if (rpaQ && rpa_omegaQ) {
+    // Each frequency starts from neighbouring solution; chunks of the
+    // frequency grid are solved in parallel
+    dVE1.solve_sweep(
+        w_list,
+        [&](const ExternalField::CorePolarisation &dV, std::size_t iw) {
+          calc_alpha(static_cast<const ExternalField::TDHF &>(dV), iw);
+        },
+        128, true);
+  } else {
+    for (std::size_t iw = 0; iw < w_list.size(); ++iw) {
+      calc_alpha(dVE1, iw);
+    }
+  }
+
+  for (std::size_t iw = 0; iw < w_list.size(); ++iw) {
+    const auto ww = w_list.at(iw);
+    const auto &[ac, avs, a2s, eps] = alphas.at(iw);
+    const auto lambda = (2.0 * M_PI * PhysConst::c / ww) * PhysConst::aB_nm;
+
+    // if <20, print all; otherwise, first + last + every 20th
+    const auto print = w_list.size() < 20 ?
+                           true :
+                           (iw == 0 || iw + 1 == w_list.size() ||
+                            ((iw + 1) % 20 == 0));
+
+    if (print)
+      printf("%9.2e %9.2e %9.2e ", ww, lambda, ac);
+    ofile << ww << " " << lambda << " " << ac << " ";
+    // no core contrib to a2, but write zero so columns align
+    o2file << ww << " " << lambda << " " << 0.0 << " ";
     for (auto &av : avs) {
       if (print)
         printf("%9.2e ", av);
@@ -571,8 +587,8 @@ void dynamicPolarisability(const IO::InputBlock &input,
     }
     if (rpaQ && rpa_omegaQ) {
       if (print)
-        printf("[%.0e]", dVE1.get_eps());
-      ofile << dVE1.get_eps();
+        printf("[%.0e]", eps);
+      ofile << eps;
     }
     if (print)
       std::cout << "\n";
@@ -590,7 +606,7 @@ void dynamicPolarisability(const IO::InputBlock &input,
         o2file << a2 << " ";
       }
       if (rpaQ && rpa_omegaQ)
-        o2file << dVE1.get_eps();
+        o2file << eps;
       if (print)
         std::cout << "\n";
       o2file << "\n";
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <utility>
 
@@ -93,7 +94,15 @@ std::vector<DiracSpinor> form_basis(const Parameters &params,
 
     auto [Aij, Sij] = fill_Hamiltonian_matrix(spl_basis, d_basis, wf,
                                               correlationsQ, basis_type);
-    const auto [e_values, e_vectors] = LinAlg::symmhEigensystem(Aij, Sij);
+    // If positron states are not kept, find only the positive-energy ones
+    const auto neg_mc2 = -1.0 / (wf.alpha() * wf.alpha());
+    const auto range =
+        positronQ ?
+            LinAlg::EigenRange::all() :
+            LinAlg::EigenRange::value(neg_mc2,
+                                      std::numeric_limits<double>::max());
+    const auto [e_values, e_vectors] =
+        LinAlg::symmhEigensystem(std::move(Aij), std::move(Sij), range);
 
     expand_basis_orbitals(&basis, &basis_positron, spl_basis, kappa, max_n,
                           e_values, e_vectors, wf);
@@ -10,7 +10,94 @@
 #include "qip/Vector.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <vector>
+
+//==============================================================================
+namespace {
+
+// Process-wide cache of continuum solutions: {potential hash, energy, kappa}
+using CntmKey = std::tuple<std::uint64_t, double, int>;
+
+struct CntmCache {
+  std::map<CntmKey, DiracSpinor> states{};
+  std::size_t budget{256ul * 1024 * 1024};
+  std::size_t bytes{0};
+  std::size_t hits{0};
+  std::size_t misses{0};
+  std::mutex mutex{};
+};
+
+CntmCache &cntm_cache() {
+  static CntmCache cache;
+  return cache;
+}
+
+// FNV-1a
+void hash_bytes(std::uint64_t &hash, const void *data, std::size_t num_bytes) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < num_bytes; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+// Hash of everything (other than energy and kappa) a continuum solution
+// depends on. Fi only matters if orthogonality to it is forced.
+std::uint64_t potential_hash(const HF::HartreeFock *hf, double alpha,
+                             const std::vector<double> &vc,
+                             const DiracSpinor *Fi, bool force_orthog,
+                             bool zeff) {
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto hf_id = reinterpret_cast<std::uintptr_t>(hf);
+  const int method[3] = {hf ? int(hf->method()) : -1,
+                         hf ? int(hf->excludeExchangeQ()) : -1, int(zeff)};
+  hash_bytes(hash, &hf_id, sizeof(hf_id));
+  hash_bytes(hash, &alpha, sizeof(alpha));
+  hash_bytes(hash, method, sizeof(method));
+  hash_bytes(hash, vc.data(), vc.size() * sizeof(double));
+  hash_bytes(hash, &force_orthog, sizeof(force_orthog));
+  if (force_orthog && Fi != nullptr) {
+    const int nk[2] = {Fi->n(), Fi->kappa()};
+    hash_bytes(hash, nk, sizeof(nk));
+    hash_bytes(hash, Fi->f().data(), Fi->f().size() * sizeof(double));
+    hash_bytes(hash, Fi->g().data(), Fi->g().size() * sizeof(double));
+  }
+  return hash;
+}
+
+// Copies cached state into Fc, if it exists. Returns true if found
+bool cache_lookup(const CntmKey &key, DiracSpinor &Fc) {
+  auto &cache = cntm_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.budget == 0)
+    return false;
+  const auto it = cache.states.find(key);
+  if (it == cache.states.end()) {
+    ++cache.misses;
+    return false;
+  }
+  ++cache.hits;
+  Fc = it->second;
+  return true;
+}
+
+// Stores Fc in cache, if there is room in the budget
+void cache_store(const CntmKey &key, const DiracSpinor &Fc) {
+  auto &cache = cntm_cache();
+  const auto size = 2 * Fc.f().size() * sizeof(double);
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.bytes + size > cache.budget)
+    return;
+  if (cache.states.emplace(key, Fc).second)
+    cache.bytes += size;
+}
+
+} // namespace
+
 //==============================================================================
 ContinuumOrbitals::ContinuumOrbitals(const Wavefunction &wf)
     : rgrid(wf.grid_sptr()), p_hf(wf.vHF()), alpha(wf.alpha()) {}
@@ -82,7 +169,47 @@ int ContinuumOrbitals::solveContinuumHF(double ec, int min_l, int max_l,
     }
   }
 
+  // Add each kappa state; those already in cache needn't be solved
+  const auto hash =
+      potential_hash(p_hf, alpha, vc, Fi, force_orthog_Fi, false);
+  const auto to_solve = add_orbitals(ec, min_l, max_l, hash);
+
+  // solve initial, without exchange term (all kappas solved together)
+  solveInitial(ec, vc, to_solve);
+
+  // Then, include exchange correction:
+  if (p_hf != nullptr && !p_hf->excludeExchangeQ()) {
+    for (auto *Fc : to_solve) {
+      IncludeExchange(*Fc, Fi, force_orthog_Fi, vc);
+    }
+  }
+
+  // Orthogonalise against entire core:
+  if (orthog_core) {
+    for (auto *Fc : to_solve) {
+      for (const auto &Fa : p_hf->core()) {
+        if (Fa.kappa() == Fc->kappa())
+          *Fc -= (*Fc * Fa) * Fa;
+      }
+      // orthod wrt rest of core can slightly ruin "main" orthog condition
+      if (force_orthog_Fi && Fi != nullptr && Fi->kappa() == Fc->kappa()) {
+        *Fc -= (*Fi * *Fc) * *Fi;
+      }
+    }
+  }
+
+  for (const auto *Fc : to_solve) {
+    cache_store({hash, ec, Fc->kappa()}, *Fc);
+  }
+
+  return 0;
+}
+
+//==============================================================================
+std::vector<DiracSpinor *> ContinuumOrbitals::add_orbitals(
+    double ec, int min_l, int max_l, std::uint64_t potential_hash) {
   // loop through each kappa state
+  const auto first_new = orbitals.size();
   for (int k_i = 0; true; ++k_i) {
     const auto kappa = Angular::kappaFromIndex(k_i);
     const auto l = Angular::l_k(kappa);
@@ -93,30 +220,23 @@ int ContinuumOrbitals::solveContinuumHF(double ec, int min_l, int max_l,
 
     auto &Fc = orbitals.emplace_back(0, kappa, rgrid);
     Fc.en() = ec;
-    // solve initial, without exchange term
-    DiracODE::solveContinuum(Fc, ec, vc, alpha);
-    // Then, include exchange correction:
-    if (p_hf != nullptr && !p_hf->excludeExchangeQ()) {
-      IncludeExchange(Fc, Fi, force_orthog_Fi, vc);
-    }
 
   } // kappa
 
-  // Orthogonalise against entire core:
-  if (orthog_core) {
-    for (auto &Fc : orbitals) {
-      for (const auto &Fa : p_hf->core()) {
-        if (Fa.kappa() == Fc.kappa())
-          Fc -= (Fc * Fa) * Fa;
-      }
-      // orthod wrt rest of core can slightly ruin "main" orthog condition
-      if (force_orthog_Fi && Fi != nullptr && Fi->kappa() == Fc.kappa()) {
-        Fc -= (*Fi * Fc) * *Fi;
-      }
-    }
+  // nb: must not take pointers until all orbitals added
+  std::vector<DiracSpinor *> to_solve;
+  for (auto i = first_new; i < orbitals.size(); ++i) {
+    if (!cache_lookup({potential_hash, ec, orbitals[i].kappa()}, orbitals[i]))
+      to_solve.push_back(&orbitals[i]);
   }
+  return to_solve;
+}
 
-  return 0;
+//******************************************************************************
+void ContinuumOrbitals::solveInitial(double ec, const std::vector<double> &vc,
+                                     const std::vector<DiracSpinor *> &Fcs) {
+  if (!Fcs.empty())
+    DiracODE::solveContinuum(Fcs, ec, vc, alpha);
 }
 
 //******************************************************************************
@@ -169,28 +289,19 @@ int ContinuumOrbitals::solveContinuumZeff(double ec, int min_l, int max_l,
   // Zeff potential (pointlike nucleus, spherical with Rn=0):
   const auto vc = Nuclear::sphericalNuclearPotential(Z_eff, 0.0, rgrid->r());
 
-  // loop through each kappa state
-  for (int k_i = 0; true; ++k_i) {
-    const auto kappa = Angular::kappaFromIndex(k_i);
-    const auto l = Angular::l_k(kappa);
-    if (l < min_l)
-      continue;
-    if (l > max_l)
-      break;
-
-    auto &Fc = orbitals.emplace_back(0, kappa, rgrid);
-    Fc.en() = ec;
-    // solve initial, without exchange term
-    DiracODE::solveContinuum(Fc, ec, vc, alpha);
+  // Add each kappa state; those already in cache needn't be solved
+  const auto hash = potential_hash(p_hf, alpha, vc, Fi, force_orthog, true);
+  const auto to_solve = add_orbitals(ec, min_l, max_l, hash);
 
-  } // kappa
+  // solve all kappas together (no exchange term)
+  solveInitial(ec, vc, to_solve);
 
   // Orthogonalise against entire core:
   if (orthog_core) {
-    for (auto &Fc : orbitals) {
+    for (auto *Fc : to_solve) {
       for (const auto &Fa : p_hf->core()) {
-        if (Fa.kappa() == Fc.kappa())
-          Fc -= (Fc * Fa) * Fa;
+        if (Fa.kappa() == Fc->kappa())
+          *Fc -= (*Fc * Fa) * Fa;
       }
     }
   }
@@ -198,15 +309,44 @@ int ContinuumOrbitals::solveContinuumZeff(double ec, int min_l, int max_l,
   // Forcing orthogonality between continuum states and current core state
   // (have to do this _after_ orthog_core, since that slightly breaks this)
   if (force_orthog) {
-    for (auto &Fc : orbitals) {
-      if (Fi != nullptr && Fi->kappa() == Fc.kappa()) {
-        Fc -= (*Fi * Fc) * *Fi;
+    for (auto *Fc : to_solve) {
+      if (Fi != nullptr && Fi->kappa() == Fc->kappa()) {
+        *Fc -= (*Fi * *Fc) * *Fi;
       }
     }
   }
 
+  for (const auto *Fc : to_solve) {
+    cache_store({hash, ec, Fc->kappa()}, *Fc);
+  }
+
   return 0;
 }
 
 //==============================================================================
 void ContinuumOrbitals::clear() { orbitals.clear(); }
+
+//==============================================================================
+void ContinuumOrbitals::set_cache_budget(std::size_t max_bytes) {
+  auto &cache = cntm_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.budget = max_bytes;
+  if (cache.bytes > max_bytes) {
+    cache.states.clear();
+    cache.bytes = 0;
+  }
+}
+
+void ContinuumOrbitals::clear_cache() {
+  auto &cache = cntm_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.states.clear();
+  cache.bytes = 0;
+}
+
+std::tuple<std::size_t, std::size_t, std::size_t>
+ContinuumOrbitals::cache_stats() {
+  auto &cache = cntm_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return {cache.hits, cache.misses, cache.bytes};
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "Wavefunction/DiracSpinor.hpp"
+#include <cstdint>
 #include <memory>
+#include <tuple>
 #include <vector>
 class Wavefunction;
 class Grid;
@@ -37,9 +39,33 @@ public:
   //! Resets (deletes) all orbitals
   void clear();
 
+  //! Sets memory budget (bytes) of the process-wide cache of continuum
+  //! solutions. 0 disables the cache. Default is 256 MB.
+  /*! @details
+  Each solution is stored against (potential, energy, kappa), where
+  'potential' includes everything the solution depends on: the local
+  potential (after hole-particle/rescaling), the Hartree-Fock object, and the
+  ionised state if orthogonality to it is forced. Repeated requests for the
+  same state (e.g., for each L and q in RPA, or on restart) copy it from the
+  cache rather than re-solving. Once the budget is reached, no new solutions
+  are added (existing ones are kept). Thread-safe.
+  */
+  static void set_cache_budget(std::size_t max_bytes);
+  //! Clears the process-wide cache of continuum solutions
+  static void clear_cache();
+  //! Returns {hits, misses, bytes used} for process-wide continuum cache
+  static std::tuple<std::size_t, std::size_t, std::size_t> cache_stats();
+
   std::vector<DiracSpinor> orbitals{};
 
 private:
+  // Solves (local potential, no exchange) for given orbitals, together
+  void solveInitial(double ec, const std::vector<double> &vc,
+                    const std::vector<DiracSpinor *> &Fcs);
+  // Adds orbitals with l in [min_l, max_l]; copies from cache those that
+  // exist, and returns pointers to those that must be solved
+  std::vector<DiracSpinor *> add_orbitals(double ec, int min_l, int max_l,
+                                          std::uint64_t potential_hash);
   void IncludeExchange(DiracSpinor &Fe, const DiracSpinor *psi,
                        bool force_orthog, const std::vector<double> &vc);
 
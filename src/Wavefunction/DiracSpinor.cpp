@@ -199,6 +199,45 @@ DiracSpinor operator*(const std::vector<double> &v, DiracSpinor rhs) {
   return rhs *= v;
 }
 
+//------------------------------------------------------------------------------
+DiracSpinor &DiracSpinor::add(double x, const DiracSpinor &Fb) {
+  if (Fb.max_pt() > m_pinf)
+    m_pinf = Fb.max_pt();
+  if (Fb.min_pt() < m_p0)
+    m_p0 = Fb.min_pt();
+
+  const auto *const fb = Fb.m_f.data();
+  const auto *const gb = Fb.m_g.data();
+  auto *const fa = m_f.data();
+  auto *const ga = m_g.data();
+  for (std::size_t i = Fb.min_pt(); i < Fb.max_pt(); i++) {
+    fa[i] += x * fb[i];
+    ga[i] += x * gb[i];
+  }
+  return *this;
+}
+
+DiracSpinor &DiracSpinor::add(double x, const std::vector<double> &v,
+                              const DiracSpinor &Fb) {
+  if (Fb.max_pt() > m_pinf)
+    m_pinf = Fb.max_pt();
+  if (Fb.min_pt() < m_p0)
+    m_p0 = Fb.min_pt();
+
+  const auto *const fb = Fb.m_f.data();
+  const auto *const gb = Fb.m_g.data();
+  const auto *const vi = v.data();
+  auto *const fa = m_f.data();
+  auto *const ga = m_g.data();
+  const auto max = std::min(Fb.max_pt(), v.size());
+  for (std::size_t i = Fb.min_pt(); i < max; i++) {
+    const auto xv = x * vi[i];
+    fa[i] += xv * fb[i];
+    ga[i] += xv * gb[i];
+  }
+  return *this;
+}
+
 //==============================================================================
 //==============================================================================
 // comparitor overloads:
@@ -33,6 +33,8 @@ Takes in constant n and k=kappa values + grid
   - Fa == Fb returns true if {na,ka}=={nb,kb}
   - Fa > Fb : first compares n, and then kappa (via kappa_index)
   - Fa +/- Fb : Adds/subtracts the two spinors (and updates p0/pinf)
+  - Fa.add(x, Fb) and Fa.add(x, v, Fb) are fused versions of Fa += x * Fb and
+    Fa += x * v * Fb: these form no temporaries, so are preferred in hot loops
   - You can make copies: auto Fnew = Fa
   - And you can re-asign: Fb = Fa (provided Fa and Fb have same n and kappa!)
   - n and kappa are constant, cannot be changed. Avoids angular errors.
@@ -197,6 +199,14 @@ public:
   DiracSpinor &operator*=(const std::vector<double> &v);
   friend DiracSpinor operator*(const std::vector<double> &v, DiracSpinor Fa);
 
+  //! Fused multiply-add: *this += x * Fb, without forming any temporary.
+  //! Only loops over [Fb.min_pt(), Fb.max_pt())
+  DiracSpinor &add(double x, const DiracSpinor &Fb);
+  //! Fused multiply-add: *this += x * v(r) * Fb, without forming any
+  //! temporary. Only loops over non-zero part of Fb (and v)
+  DiracSpinor &add(double x, const std::vector<double> &v,
+                   const DiracSpinor &Fb);
+
   //! Comparitor overloads (compares n, then kappa):
   friend bool operator==(const DiracSpinor &lhs, const DiracSpinor &rhs);
   friend bool operator!=(const DiracSpinor &lhs, const DiracSpinor &rhs);
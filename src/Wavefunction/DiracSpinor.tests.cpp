@@ -0,0 +1,166 @@
+#include "Wavefunction/DiracSpinor.hpp"
+#include "Angular/Angular.hpp"
+#include "Coulomb/CoulombIntegrals.hpp"
+#include "Coulomb/YkTable.hpp"
+#include "HF/HartreeFock.hpp"
+#include "IO/ChronoTimer.hpp"
+#include "MBPT/Goldstone.hpp"
+#include "Maths/Grid.hpp"
+#include "Wavefunction/Wavefunction.hpp"
+#include "catch2/catch.hpp"
+#include "qip/Vector.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+//==============================================================================
+// Counts heap allocations (for the benchmark below). Replaces global new for
+// the test executable; just forwards to malloc/free.
+namespace {
+std::atomic<std::size_t> g_num_allocs{0};
+}
+void *operator new(std::size_t size) {
+  ++g_num_allocs;
+  if (void *p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc{};
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+//==============================================================================
+TEST_CASE("DiracSpinor: fused add", "[DiracSpinor][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "DiracSpinor: fused add\n";
+
+  const auto grid = std::make_shared<const Grid>(1.0e-4, 50.0, 500ul,
+                                                 GridType::loglinear, 10.0);
+
+  auto Fa = DiracSpinor::exactHlike(3, -1, grid, 2.0);
+  auto Fb = DiracSpinor::exactHlike(2, -1, grid, 1.0);
+  Fb.min_pt() = 10;
+  Fb.max_pt() = 400;
+  Fb.zero_boundaries();
+  const auto v = qip::scale(grid->r(), 0.5);
+  const auto x = -1.7;
+
+  // Fa += x * Fb
+  const auto expected1 = Fa + x * Fb;
+  auto Fa1 = Fa;
+  Fa1.add(x, Fb);
+  REQUIRE(Fa1.min_pt() == expected1.min_pt());
+  REQUIRE(Fa1.max_pt() == expected1.max_pt());
+  for (std::size_t i = 0; i < grid->num_points(); ++i) {
+    REQUIRE(Fa1.f(i) == expected1.f(i));
+    REQUIRE(Fa1.g(i) == expected1.g(i));
+  }
+
+  // Fa += x * v * Fb
+  const auto expected2 = Fa + (qip::scale(v, x) * Fb);
+  auto Fa2 = Fa;
+  Fa2.add(x, v, Fb);
+  REQUIRE(Fa2.min_pt() == expected2.min_pt());
+  REQUIRE(Fa2.max_pt() == expected2.max_pt());
+  for (std::size_t i = 0; i < grid->num_points(); ++i) {
+    REQUIRE(Fa2.f(i) == expected2.f(i));
+    REQUIRE(Fa2.g(i) == expected2.g(i));
+  }
+
+  // Range is extended to include that of Fb
+  DiracSpinor Fc{0, -1, grid};
+  Fc.min_pt() = 50;
+  Fc.max_pt() = 100;
+  Fc.add(1.0, Fb);
+  REQUIRE(Fc.min_pt() == Fb.min_pt());
+  REQUIRE(Fc.max_pt() == Fb.max_pt());
+  REQUIRE(Fc * Fc == Approx(Fb * Fb));
+}
+
+//==============================================================================
+// Compares fused/buffer re-using spinor arithmetic against the naive form
+// (full-grid temporaries), for vexFa and Goldstone Sigma_direct
+TEST_CASE("DiracSpinor: arithmetic benchmark",
+          "[DiracSpinor][benchmark][.]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "DiracSpinor: arithmetic benchmark\n";
+
+  Wavefunction wf({2000, 1.0e-6, 120.0, 40.0, "loglinear"},
+                  {"Cs", -1, "Fermi"}, 1.0);
+  wf.solve_core("HartreeFock", 0.0, "[Xe]", 1.0e-6, false);
+  wf.solve_valence("6sp5d", false);
+
+  // Naive form: forms temporaries for each term
+  const auto vexFa_naive = [](const DiracSpinor &Fa,
+                              const std::vector<DiracSpinor> &core) {
+    DiracSpinor VxFa(Fa.n(), Fa.kappa(), Fa.grid_sptr());
+    VxFa.max_pt() = 0;
+    for (const auto &Fb : core) {
+      VxFa.max_pt() = std::max(VxFa.max_pt(), Fb.max_pt());
+      const auto [kmin, kmax] = Angular::kminmax_Ck(Fa.kappa(), Fb.kappa());
+      for (int k = kmin; k <= kmax; k += 2) {
+        const auto xb = (Fa == Fb && k == 0) ? 1.0 : Fb.occ_frac();
+        const auto ckab = Angular::Ck_kk(k, Fa.kappa(), Fb.kappa());
+        const auto vabk = Coulomb::yk_ab(k, Fb, Fa, Fb.max_pt());
+        const auto c2x = ckab * ckab * xb;
+        VxFa -= qip::scale(vabk, c2x) * Fb;
+      }
+    }
+    VxFa *= (1.0 / Fa.twojp1());
+    return VxFa;
+  };
+
+  const int num_reps = 20;
+  {
+    std::size_t allocs_naive{0}, allocs_fused{0};
+    IO::ChronoTimer t_naive, t_fused;
+    t_naive.stop();
+    t_fused.stop();
+    double worst = 0.0;
+    for (int rep = 0; rep < num_reps; ++rep) {
+      for (const auto &Fv : wf.valence()) {
+        const auto a0 = g_num_allocs.load();
+        t_naive.start();
+        const auto VxF_naive = vexFa_naive(Fv, wf.core());
+        t_naive.stop();
+        const auto a1 = g_num_allocs.load();
+        t_fused.start();
+        const auto VxF_fused = HF::vexFa(Fv, wf.core());
+        t_fused.stop();
+        const auto a2 = g_num_allocs.load();
+        allocs_naive += a1 - a0;
+        allocs_fused += a2 - a1;
+        const auto del = VxF_naive - VxF_fused;
+        const auto eps = std::sqrt((del * del) / (VxF_naive * VxF_naive));
+        worst = std::max(worst, eps);
+      }
+    }
+    const auto n_calls = double(num_reps) * double(wf.valence().size());
+    std::cout << "vexFa: naive : " << t_naive.reading_ms() / n_calls
+              << " ms/call, " << double(allocs_naive) / n_calls
+              << " allocs/call\n";
+    std::cout << "vexFa: fused : " << t_fused.reading_ms() / n_calls
+              << " ms/call, " << double(allocs_fused) / n_calls
+              << " allocs/call\n";
+    CHECK(worst < 1.0e-12);
+    CHECK(allocs_fused < allocs_naive);
+  }
+
+  {
+    wf.formBasis({"30spdf", 40, 7, 1.0e-4, 1.0e-4, 40.0, false});
+    const auto i0 = wf.grid().getIndex(1.0e-3);
+    const std::size_t stride = 8;
+    const auto size = (wf.grid().getIndex(30.0) - i0) / stride + 1;
+    MBPT::Goldstone Gs(wf.basis(), wf.core(), i0, stride, size, 3, false);
+    const auto &Fv = wf.valence().front();
+
+    const auto a0 = g_num_allocs.load();
+    IO::ChronoTimer timer;
+    const auto Sd = Gs.Sigma_direct(Fv.kappa(), Fv.en());
+    const auto t = timer.reading_ms();
+    const auto allocs = g_num_allocs.load() - a0;
+    std::cout << "Sigma_direct: " << t << " ms, " << allocs << " allocs\n";
+    std::cout << "<v|Sigma_d|v> = " << Fv * (Sd * Fv) << "\n";
+  }
+}
@@ -0,0 +1,103 @@
+#include "OrbitalSet.hpp"
+#include "Angular/Wigner369j.hpp"
+#include "Maths/Grid.hpp"
+#include "Maths/NumCalc_quadIntegrate.hpp"
+#include "Wavefunction/DiracSpinor.hpp"
+#include <algorithm>
+#include <cassert>
+
+//==============================================================================
+OrbitalSet::OrbitalSet(std::shared_ptr<const Grid> rgrid)
+    : m_rgrid(std::move(rgrid)),
+      m_num_points(m_rgrid->num_points()),
+      m_stride(row_size(m_num_points)) {}
+
+//------------------------------------------------------------------------------
+OrbitalSet::OrbitalSet(const std::vector<DiracSpinor> &orbs)
+    : OrbitalSet(orbs.front().grid_sptr()) {
+  m_info.reserve(orbs.size());
+  m_data.reserve(2 * orbs.size() * m_stride);
+  for (const auto &Fa : orbs) {
+    push_back(Fa);
+  }
+}
+
+//==============================================================================
+void OrbitalSet::push_back(const DiracSpinor &Fa) {
+  assert(Fa.grid().num_points() == m_num_points);
+  m_info.push_back(
+      {Fa.n(), Fa.kappa(), Fa.en(), Fa.occ_frac(), Fa.min_pt(), Fa.max_pt()});
+  // nb: padding at end of each row is zero
+  m_data.resize(2 * m_info.size() * m_stride, 0.0);
+  set(m_info.size() - 1, Fa);
+}
+
+//------------------------------------------------------------------------------
+void OrbitalSet::set(std::size_t i, const DiracSpinor &Fa) {
+  auto &info = m_info.at(i);
+  assert(info.n == Fa.n() && info.kappa == Fa.kappa());
+  info.en = Fa.en();
+  info.occ_frac = Fa.occ_frac();
+  info.min_pt = Fa.min_pt();
+  info.max_pt = Fa.max_pt();
+  std::copy(Fa.f().cbegin(), Fa.f().cend(), f(i));
+  std::copy(Fa.g().cbegin(), Fa.g().cend(), g(i));
+}
+
+//==============================================================================
+OrbitalSet::View OrbitalSet::operator[](std::size_t i) const {
+  return View{this, i};
+}
+
+OrbitalSet::View OrbitalSet::at(std::size_t i) const {
+  (void)m_info.at(i); // bounds check
+  return View{this, i};
+}
+
+//==============================================================================
+DiracSpinor OrbitalSet::spinor(std::size_t i) const {
+  const auto &info = m_info.at(i);
+  DiracSpinor Fa(info.n, info.kappa, m_rgrid);
+  Fa.en() = info.en;
+  Fa.occ_frac() = info.occ_frac;
+  Fa.min_pt() = info.min_pt;
+  Fa.max_pt() = info.max_pt;
+  std::copy(f(i), f(i) + m_num_points, Fa.f().begin());
+  std::copy(g(i), g(i) + m_num_points, Fa.g().begin());
+  return Fa;
+}
+
+//------------------------------------------------------------------------------
+std::vector<DiracSpinor> OrbitalSet::spinors() const {
+  std::vector<DiracSpinor> out;
+  out.reserve(size());
+  for (std::size_t i = 0; i < size(); ++i) {
+    out.push_back(spinor(i));
+  }
+  return out;
+}
+
+//------------------------------------------------------------------------------
+std::size_t OrbitalSet::find(int n, int kappa) const {
+  const auto it =
+      std::find_if(m_info.cbegin(), m_info.cend(), [n, kappa](const auto &a) {
+        return a.n == n && a.kappa == kappa;
+      });
+  return std::size_t(it - m_info.cbegin());
+}
+
+//==============================================================================
+int OrbitalSet::View::l() const { return Angular::l_k(kappa()); }
+int OrbitalSet::View::twoj() const { return Angular::twoj_k(kappa()); }
+
+//------------------------------------------------------------------------------
+double operator*(const OrbitalSet::View &Fa, const OrbitalSet::View &Fb) {
+  // Note: ONLY radial part ("F" radial spinor)
+  const auto imin = std::max(Fa.min_pt(), Fb.min_pt());
+  const auto imax = std::min(Fa.max_pt(), Fb.max_pt());
+  const auto &gr = Fa.grid();
+  const auto &dr = gr.drdu();
+  return (NumCalc::integrate(1, imin, imax, Fa.f(), Fb.f(), dr) +
+          NumCalc::integrate(1, imin, imax, Fa.g(), Fb.g(), dr)) *
+         gr.du();
+}
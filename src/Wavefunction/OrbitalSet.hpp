@@ -0,0 +1,177 @@
+#pragma once
+#include "qip/Array.hpp"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+class Grid;
+class DiracSpinor;
+
+//==============================================================================
+//! Minimal allocator returning memory aligned to Alignment bytes
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+  using value_type = T;
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+  }
+  void deallocate(T *p, std::size_t) {
+    ::operator delete(p, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment> &) const {
+    return false;
+  }
+};
+
+//==============================================================================
+/*!
+@brief Set of radial Dirac spinors (e.g., a basis), stored contiguously.
+@details
+Structure-of-arrays alternative to std::vector<DiracSpinor>. The f and g
+components of all orbitals are stored in a single 2D array, with rows
+  {f_0, g_0, f_1, g_1, ...}
+Each row is padded to a multiple of 8 doubles, and the storage is 64-byte
+aligned, so every row starts on a cache line. Quantum numbers, energies, and
+[min_pt, max_pt) are stored alongside.
+
+  - Construct from (or convert back to) std::vector<DiracSpinor>, so code can
+    adopt this incrementally
+  - OrbitalSet::View is a light-weight, non-owning, read-only view of a single
+    orbital, with the same accessors as DiracSpinor (f(), g(), f(i), kappa(),
+    min_pt(), ...). Functions templated on the spinor type (e.g.,
+    Coulomb::yk_ab) accept either
+  - Views are invalidated by push_back() (storage may be re-allocated)
+*/
+class OrbitalSet {
+
+public:
+  //! Non-owning, read-only view onto a single orbital in the set
+  class View;
+
+private:
+  // Per-orbital data (everything except the radial functions)
+  struct Info {
+    int n;
+    int kappa;
+    double en;
+    double occ_frac;
+    std::size_t min_pt;
+    std::size_t max_pt;
+  };
+
+  std::shared_ptr<const Grid> m_rgrid;
+  std::size_t m_num_points;
+  // Row length: num_points, rounded up to multiple of 8 (64 bytes)
+  std::size_t m_stride;
+  std::vector<Info> m_info{};
+  std::vector<double, AlignedAllocator<double>> m_data{};
+
+public:
+  //! Empty set, on given grid
+  explicit OrbitalSet(std::shared_ptr<const Grid> rgrid);
+  //! Copies the orbitals into contiguous storage. orbs must not be empty
+  explicit OrbitalSet(const std::vector<DiracSpinor> &orbs);
+
+  //! Number of orbitals in set
+  std::size_t size() const { return m_info.size(); }
+  bool empty() const { return m_info.empty(); }
+  //! Number of radial grid points
+  std::size_t num_points() const { return m_num_points; }
+  //! Distance (in doubles) between consecutive rows of the underlying array
+  std::size_t stride() const { return m_stride; }
+
+  const Grid &grid() const { return *m_rgrid; }
+  std::shared_ptr<const Grid> grid_sptr() const { return m_rgrid; }
+
+  //! Copies Fa into the set (at the end). Invalidates existing Views
+  void push_back(const DiracSpinor &Fa);
+
+  //! View onto the i-th orbital (no bounds checking)
+  View operator[](std::size_t i) const;
+  //! View onto the i-th orbital (bounds checked)
+  View at(std::size_t i) const;
+
+  //! Pointer to f (or g) of i-th orbital; contiguous, num_points() long
+  double *f(std::size_t i) { return m_data.data() + (2 * i) * m_stride; }
+  const double *f(std::size_t i) const {
+    return m_data.data() + (2 * i) * m_stride;
+  }
+  double *g(std::size_t i) { return m_data.data() + (2 * i + 1) * m_stride; }
+  const double *g(std::size_t i) const {
+    return m_data.data() + (2 * i + 1) * m_stride;
+  }
+
+  //! Overwrites i-th orbital with Fa (must have same n and kappa)
+  void set(std::size_t i, const DiracSpinor &Fa);
+
+  //! Copies the i-th orbital into a (new) DiracSpinor
+  DiracSpinor spinor(std::size_t i) const;
+  //! Copies entire set back into a std::vector<DiracSpinor>
+  std::vector<DiracSpinor> spinors() const;
+
+  //! Index of orbital {n,kappa} in the set; size() if not found
+  std::size_t find(int n, int kappa) const;
+
+private:
+  std::size_t row_size(std::size_t num_points) const {
+    return 8 * ((num_points + 7) / 8);
+  }
+};
+
+//==============================================================================
+class OrbitalSet::View {
+  friend class OrbitalSet;
+  const OrbitalSet *m_set;
+  std::size_t m_index;
+
+  View(const OrbitalSet *set, std::size_t index)
+      : m_set(set), m_index(index) {}
+  const Info &info() const { return m_set->m_info[m_index]; }
+
+public:
+  //! Index of this orbital in the set
+  std::size_t index() const { return m_index; }
+
+  int n() const { return info().n; }
+  int kappa() const { return info().kappa; }
+  int l() const;
+  int twoj() const;
+  int twojp1() const { return twoj() + 1; }
+  double en() const { return info().en; }
+  double occ_frac() const { return info().occ_frac; }
+  std::size_t min_pt() const { return info().min_pt; }
+  std::size_t max_pt() const { return info().max_pt; }
+
+  const Grid &grid() const { return *m_set->m_rgrid; }
+  std::shared_ptr<const Grid> grid_sptr() const { return m_set->m_rgrid; }
+
+  //! Upper (large) radial component (view over full grid)
+  qip::ArrayView<const double> f() const {
+    return {m_set->f(m_index), m_set->m_num_points};
+  }
+  //! Lower (small) radial component (view over full grid)
+  qip::ArrayView<const double> g() const {
+    return {m_set->g(m_index), m_set->m_num_points};
+  }
+  double f(std::size_t i) const { return m_set->f(m_index)[i]; }
+  double g(std::size_t i) const { return m_set->g(m_index)[i]; }
+
+  //! Returns radial integral (Fa,Fb) = Int(fa*fb + ga*gb)
+  friend double operator*(const View &Fa, const View &Fb);
+};
@@ -0,0 +1,93 @@
+#include "Wavefunction/OrbitalSet.hpp"
+#include "Angular/Angular.hpp"
+#include "Coulomb/CoulombIntegrals.hpp"
+#include "Maths/Grid.hpp"
+#include "Wavefunction/DiracSpinor.hpp"
+#include "catch2/catch.hpp"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+TEST_CASE("OrbitalSet", "[OrbitalSet][unit]") {
+  std::cout << "\n----------------------------------------\n";
+  std::cout << "OrbitalSet\n";
+
+  const auto grid = std::make_shared<const Grid>(1.0e-4, 100.0, 501ul,
+                                                 GridType::loglinear, 10.0);
+
+  std::vector<DiracSpinor> orbs;
+  for (int kappa : {-1, 1, -2, 2, -3}) {
+    const auto l = Angular::l_k(kappa);
+    for (int n = l + 1; n <= l + 3; ++n) {
+      orbs.push_back(DiracSpinor::exactHlike(n, kappa, grid, 2.0));
+      orbs.back().en() = -0.5 / (n * n);
+      orbs.back().min_pt() = std::size_t(3 * n);
+      orbs.back().max_pt() = 501 - std::size_t(20 * n);
+      orbs.back().zero_boundaries();
+    }
+  }
+
+  const OrbitalSet set(orbs);
+  REQUIRE(set.size() == orbs.size());
+  REQUIRE(set.num_points() == 501);
+  // rows are padded, and every row is 64-byte aligned
+  REQUIRE(set.stride() % 8 == 0);
+  REQUIRE(set.stride() >= set.num_points());
+  for (std::size_t i = 0; i < set.size(); ++i) {
+    REQUIRE(reinterpret_cast<std::uintptr_t>(set.f(i)) % 64 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(set.g(i)) % 64 == 0);
+  }
+
+  // Views match the original spinors exactly
+  for (std::size_t i = 0; i < set.size(); ++i) {
+    const auto &Fa = orbs[i];
+    const auto Va = set[i];
+    REQUIRE(Va.n() == Fa.n());
+    REQUIRE(Va.kappa() == Fa.kappa());
+    REQUIRE(Va.l() == Fa.l());
+    REQUIRE(Va.twoj() == Fa.twoj());
+    REQUIRE(Va.en() == Fa.en());
+    REQUIRE(Va.min_pt() == Fa.min_pt());
+    REQUIRE(Va.max_pt() == Fa.max_pt());
+    for (std::size_t j = 0; j < set.num_points(); ++j) {
+      REQUIRE(Va.f(j) == Fa.f(j));
+      REQUIRE(Va.g(j) == Fa.g(j));
+    }
+    REQUIRE(set.find(Fa.n(), Fa.kappa()) == i);
+  }
+  REQUIRE(set.find(99, -1) == set.size());
+
+  // Round trip to DiracSpinor
+  const auto orbs2 = set.spinors();
+  REQUIRE(orbs2.size() == orbs.size());
+  for (std::size_t i = 0; i < orbs.size(); ++i) {
+    REQUIRE(orbs2[i] == orbs[i]);
+    REQUIRE(orbs2[i].f() == orbs[i].f());
+    REQUIRE(orbs2[i].g() == orbs[i].g());
+    REQUIRE(orbs2[i].max_pt() == orbs[i].max_pt());
+  }
+
+  // Kernels give identical results on views and spinors
+  std::vector<double> yk_view, yk_spinor;
+  for (std::size_t a = 0; a < orbs.size(); ++a) {
+    for (std::size_t b = 0; b < orbs.size(); ++b) {
+      REQUIRE(set[a] * set[b] == orbs[a] * orbs[b]);
+      const auto [k0, ki] =
+          Angular::kminmax_Ck(orbs[a].kappa(), orbs[b].kappa());
+      for (int k = k0; k <= ki; k += 2) {
+        Coulomb::yk_ab(k, set[a], set[b], yk_view);
+        Coulomb::yk_ab(k, orbs[a], orbs[b], yk_spinor);
+        REQUIRE(yk_view == yk_spinor);
+      }
+    }
+  }
+
+  // Updating an orbital in place
+  auto set2 = set;
+  auto F0 = orbs.front();
+  F0.scale(2.0);
+  set2.set(0, F0);
+  REQUIRE(set2[0] * set2[0] == Approx(4.0 * (set[0] * set[0])));
+  REQUIRE(set2[1] * set2[1] == set[1] * set[1]);
+}
@@ -4,6 +4,7 @@
 #include "HF/HartreeFock.hpp"
 #include "IO/ChronoTimer.hpp"
 #include "IO/FRW_fileReadWrite.hpp" //just for enum..
+#include "IO/Profile.hpp"
 #include "MBPT/CorrelationPotential.hpp"
 #include "Maths/Grid.hpp"
 #include "Maths/NumCalc_quadIntegrate.hpp"
@@ -162,6 +163,7 @@ void Wavefunction::set_HF(const std::string &method, const double x_Breit,
 
 //==============================================================================
 void Wavefunction::solve_core(bool print) {
+  IO::Profile::Region profile("HF core");
   if (m_HF)
     m_HF->solve_core(print);
 }
@@ -185,6 +187,7 @@ double Wavefunction::coreEnergyHF() const {
 void Wavefunction::solve_valence(const std::string &in_valence_str,
                                  const bool print) {
 
+  IO::Profile::Region profile("HF valence");
   const auto explicite_val_list = false;
   // (m_HF && m_HF->method() == HF::Method::KohnSham);
   const auto val_lst = explicite_val_list ?
@@ -208,10 +211,13 @@ void Wavefunction::solve_valence(const std::string &in_valence_str,
   } else {
     // only for H-like:
     const double z2 = m_nucleus.z() * m_nucleus.z();
+    std::vector<DiracSpinor *> Fvs;
+    std::vector<double> e0s;
     for (auto &Fv : m_valence) {
-      const auto e0 = -0.5 * z2 / std::pow(Fv.n(), 2);
-      DiracODE::boundState(Fv, e0, vlocal(), {}, m_alpha, 1.0e-14);
+      Fvs.push_back(&Fv);
+      e0s.push_back(-0.5 * z2 / std::pow(Fv.n(), 2));
     }
+    DiracODE::boundState(Fvs, e0s, vlocal(), {}, m_alpha, 1.0e-14);
   }
 }
 
@@ -255,6 +255,23 @@ TEST_CASE("Wavefunction - continuum", "[wf][cntm][unit]") {
     auto ortho = std::abs(wf.core().front() * cntm.orbitals.front());
     std::cout << ortho << "\n";
     REQUIRE(std::abs(ortho) < 1.0e-15);
+
+    // Same states again are taken from cache, and are identical; different
+    // ionised state (with hole-particle/orthog) must be re-solved
+    const auto [hits0, misses0, bytes0] = ContinuumOrbitals::cache_stats();
+    ContinuumOrbitals cntm2(wf);
+    cntm2.solveContinuumHF(0.1, 0, 0, &wf.core().front(), false, true, true);
+    const auto [hits1, misses1, bytes1] = ContinuumOrbitals::cache_stats();
+    REQUIRE(hits1 == hits0 + 1);
+    REQUIRE(misses1 == misses0);
+    REQUIRE(cntm2.orbitals.front() == cntm.orbitals.front());
+    REQUIRE(cntm2.orbitals.front().f() == cntm.orbitals.front().f());
+    cntm2.clear();
+    cntm2.solveContinuumHF(0.1, 0, 0, &wf.core().back(), false, true, true);
+    const auto [hits2, misses2, bytes2] = ContinuumOrbitals::cache_stats();
+    REQUIRE(hits2 == hits1);
+    REQUIRE(misses2 == misses1 + 1);
+    REQUIRE(bytes2 > bytes1);
   }
 
   {
@@ -2,14 +2,59 @@
 #include "IO/ChronoTimer.hpp"
 #include "IO/FRW_fileReadWrite.hpp" //for 'ExtraPotential'
 #include "IO/InputBlock.hpp"
+#include "IO/Profile.hpp"
 #include "Maths/Grid.hpp"
 #include "Maths/Interpolator.hpp" //for 'ExtraPotential'
 #include "Modules/modules_list.hpp"
 #include "Modules/runModules.hpp"
 #include "Physics/include.hpp"
 #include "Wavefunction/Wavefunction.hpp"
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace {
+// Turns on profiling if Profile{} block given; prints summary, and writes
+// trace file, on destruction (i.e., once ampsci has finished)
+class ProfileOutput {
+  bool m_on{false};
+  std::string m_summary{};
+  std::string m_trace{};
+
+public:
+  explicit ProfileOutput(const std::optional<IO::InputBlock> &in) {
+    if (!in || in->has_option("help"))
+      return;
+    m_on = true;
+    m_summary = in->get("summary", std::string{""});
+    m_trace = in->get("trace", std::string{""});
+    const auto max_events = in->get("max_events", 1000000ul);
+    IO::Profile::enable(true, m_trace.empty() ? 0ul : max_events);
+  }
+  ~ProfileOutput() {
+    if (!m_on)
+      return;
+    if (m_summary.empty()) {
+      IO::Profile::print_summary(std::cout);
+    } else {
+      std::ofstream of(m_summary);
+      IO::Profile::print_summary(of);
+      std::cout << "Profile summary written to: " << m_summary << "\n";
+    }
+    if (!m_trace.empty()) {
+      IO::Profile::write_trace(m_trace);
+      std::cout << "Profile trace written to: " << m_trace << "\n";
+    }
+    IO::Profile::enable(false);
+  }
+  ProfileOutput(const ProfileOutput &) = delete;
+  ProfileOutput &operator=(const ProfileOutput &) = delete;
+};
+} // namespace
 
 Wavefunction ampsci(const IO::InputBlock &input) {
+  // nb: constructed first, so summary includes the 'ampsci' timer below
+  const ProfileOutput profile(input.getBlock("Profile"));
   IO::ChronoTimer timer("\nampsci");
 
   using namespace std::string_literals;
@@ -44,9 +89,24 @@ Wavefunction ampsci(const IO::InputBlock &input) {
        {"Spectrum{}",
         "Like basis, but includes correlations. Used for sum-over-states"},
        {"CI{}", "Configuration Interaction"},
+       {"Profile{}", "Time each stage of the calculation (off by default)"},
        {"Module::*{}", "Run any number of modules (* -> module name). `ampsci "
                        "-m` to see available modules"}});
 
+  input.check(
+      {"Profile"},
+      {{"", "Hierarchical timing profile of each stage (HF, basis, Coulomb "
+            "integrals, Sigma, CI, RPA, modules, ...), including time on each "
+            "thread. Printed once ampsci finishes. Adding this block turns "
+            "profiling on."},
+       {"summary",
+        "File to write summary to. Blank => print to screen [blank]"},
+       {"trace", "File to write Chrome-trace (JSON) of every region call to; "
+                 "view with chrome://tracing or ui.perfetto.dev. Blank => "
+                 "none [blank]"},
+       {"max_events", "Maximum number of trace events stored per thread "
+                      "[1000000]"}});
+
   //----------------------------------------------------------------------------
   // Atom: Get + setup atom parameters
   input.check(